@@ -0,0 +1,49 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignments Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignments Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: Dual-cost gap-affine penalties (matches are free)
+ */
+
+#ifndef AFFINE2P_PENALTIES_H_
+#define AFFINE2P_PENALTIES_H_
+
+/*
+ * Dual-cost gap-affine penalties (piece-wise affine, convex)
+ *   Each gap of length L scores MIN(gap_opening1+L*gap_extension1,gap_opening2+L*gap_extension2)
+ *   Typically gap_opening1 < gap_opening2 and gap_extension1 > gap_extension2, so that short
+ *   gaps score with the first piece and long gaps with the second
+ */
+typedef struct {
+  int mismatch;        // (X > 0)
+  int gap_opening1;    // (O1 >= 0)
+  int gap_extension1;  // (E1 > 0)
+  int gap_opening2;    // (O2 >= 0)
+  int gap_extension2;  // (E2 > 0)
+} affine2p_penalties_t;
+
+#endif /* AFFINE2P_PENALTIES_H_ */
@@ -41,6 +41,7 @@ void cigar_allocate(
     mm_allocator_t* const mm_allocator) {
   cigar->max_operations = pattern_length+text_length;
   cigar->operations = mm_allocator_malloc(mm_allocator,cigar->max_operations);
+  cigar->segment_ids = mm_allocator_calloc(mm_allocator,cigar->max_operations,int,false);
   cigar->begin_offset = cigar->max_operations;
   cigar->end_offset = cigar->max_operations;
   cigar->score = INT32_MIN;
@@ -54,6 +55,7 @@ void cigar_clear(
 void cigar_free(
     cigar_t* const cigar,
     mm_allocator_t* const mm_allocator) {
+  mm_allocator_free(mm_allocator,cigar->segment_ids);
   mm_allocator_free(mm_allocator,cigar->operations);
 }
 /*
@@ -124,7 +126,8 @@ void cigar_add_segment(
     cigar_t* const cigar,
     const int segment_idx) {
   --(cigar->begin_offset);
-  cigar->operations[cigar->begin_offset] = (char)(segment_idx + 48);
+  cigar->operations[cigar->begin_offset] = CIGAR_OP_SEGMENT;
+  cigar->segment_ids[cigar->begin_offset] = segment_idx;
 }
 /*
  * Score
@@ -143,6 +146,64 @@ int cigar_score_edit(
   }
   return score;
 }
+int cigar_score_gap_affine(
+    cigar_t* const cigar,
+    affine_penalties_t* const penalties) {
+  // Score operations (segment-ids are skipped, so gaps continue across segments)
+  char last_operation = 'M';
+  int score = 0, i;
+  for (i=cigar->begin_offset;i<cigar->end_offset;++i) {
+    const char operation = cigar->operations[i];
+    switch (operation) {
+      case 'M': break;
+      case 'X': score += penalties->mismatch; break;
+      case 'D':
+      case 'I':
+        score += penalties->gap_extension;
+        if (last_operation != operation) score += penalties->gap_opening;
+        break;
+      default: continue; // Segment-id
+    }
+    last_operation = operation;
+  }
+  return score;
+}
+int cigar_score_gap_affine2p_gap(
+    affine2p_penalties_t* const penalties,
+    const int gap_length) {
+  // Score gap (cheapest gap-affine piece)
+  if (gap_length == 0) return 0;
+  const int score1 = penalties->gap_opening1 + gap_length*penalties->gap_extension1;
+  const int score2 = penalties->gap_opening2 + gap_length*penalties->gap_extension2;
+  return MIN(score1,score2);
+}
+int cigar_score_gap_affine2p(
+    cigar_t* const cigar,
+    affine2p_penalties_t* const penalties) {
+  // Score operations (segment-ids are skipped, so gaps continue across segments)
+  char last_operation = 'M';
+  int score = 0, gap_length = 0, i;
+  for (i=cigar->begin_offset;i<cigar->end_offset;++i) {
+    const char operation = cigar->operations[i];
+    switch (operation) {
+      case 'M':
+      case 'X':
+      case 'D':
+      case 'I':
+        if (operation != last_operation) { // Close gap
+          score += cigar_score_gap_affine2p_gap(penalties,gap_length);
+          gap_length = 0;
+        }
+        if (operation == 'X') score += penalties->mismatch;
+        if (operation == 'D' || operation == 'I') ++gap_length;
+        break;
+      default: continue; // Segment-id
+    }
+    last_operation = operation;
+  }
+  score += cigar_score_gap_affine2p_gap(penalties,gap_length);
+  return score;
+}
 /*
  * Utils
  */
@@ -156,11 +217,16 @@ int cigar_cmp(
   // Compare operations
   char* const operations_a = cigar_a->operations + cigar_a->begin_offset;
   char* const operations_b = cigar_b->operations + cigar_b->begin_offset;
+  int* const segment_ids_a = cigar_a->segment_ids + cigar_a->begin_offset;
+  int* const segment_ids_b = cigar_b->segment_ids + cigar_b->begin_offset;
   int i;
   for (i=0;i<length_cigar_a;++i) {
     if (operations_a[i] != operations_b[i]) {
       return operations_a[i] - operations_b[i];
     }
+    if (operations_a[i] == CIGAR_OP_SEGMENT && segment_ids_a[i] != segment_ids_b[i]) {
+      return segment_ids_a[i] - segment_ids_b[i];
+    }
   }
   // Equal
   return 0;
@@ -175,6 +241,9 @@ void cigar_copy(
   memcpy(cigar_dst->operations+cigar_src->begin_offset,
          cigar_src->operations+cigar_src->begin_offset,
          cigar_src->end_offset-cigar_src->begin_offset);
+  memcpy(cigar_dst->segment_ids+cigar_src->begin_offset,
+         cigar_src->segment_ids+cigar_src->begin_offset,
+         (cigar_src->end_offset-cigar_src->begin_offset)*sizeof(int));
 }
 bool cigar_check_alignment(
     FILE* const stream,
@@ -257,9 +326,9 @@ void cigar_print(
   char last_op = '\0';
   int i, last_op_length = -1;
   for (i=cigar->begin_offset;i<cigar->end_offset;++i) {
-    if ('0' <= cigar->operations[i] && cigar->operations[i] <= '9') {
+    if (cigar->operations[i] == CIGAR_OP_SEGMENT) {
       if (last_op_length != -1) fprintf(stream,"%d%c",last_op_length,last_op);
-      fprintf(stream,"(%c)",cigar->operations[i]);
+      fprintf(stream,"(%d)",cigar->segment_ids[i]);
       last_op = '\0';
       last_op_length = -1;
     } else {
@@ -34,12 +34,19 @@
 
 #include "utils/commons.h"
 #include "system/mm_allocator.h"
+#include "alignment/affine_penalties.h"
+#include "alignment/affine2p_penalties.h"
 
 /*
  * CIGAR
+ *   Segment operations (POA) mark the first operation on each text-segment
+ *   traversed, keeping its segment-id aside (segment_ids)
  */
+#define CIGAR_OP_SEGMENT '('
+
 typedef struct {
   char* operations;
+  int* segment_ids;      // Segment-id of each segment operation
   int max_operations;
   int begin_offset;
   int end_offset;
@@ -88,6 +95,12 @@ void cigar_add_segment(
  */
 int cigar_score_edit(
     cigar_t* const cigar);
+int cigar_score_gap_affine(
+    cigar_t* const cigar,
+    affine_penalties_t* const penalties);
+int cigar_score_gap_affine2p(
+    cigar_t* const cigar,
+    affine2p_penalties_t* const penalties);
 
 /*
  * Utils
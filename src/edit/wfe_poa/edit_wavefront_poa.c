@@ -33,8 +33,12 @@
 /*
  * Constants
  */
-#define EDIT_WF_POA_MAX_SEGMENTS 1000
-#define EDIT_WF_POA_MAX_SEGMENT_WAVEFRONTS 1000
+#define EDIT_WF_POA_SEGMENT_WAVEFRONTS_INIT 16
+#define EDIT_WF_POA_SEGMENT_CONTROLS_INIT    16
+#define EDIT_WF_POA_WAVEFRONTS_MM_SEGMENT    BUFFER_SIZE_1M
+
+#define EDIT_WF_CONTROL_EMPTY INT_MIN
+#define EDIT_WF_CONTROL_HASH(k) ((uint32_t)(k)*2654435761u) // Fibonacci hashing
 
 /*
  * Individual Edit Wavefront
@@ -48,10 +52,11 @@ edit_wavefront_t* edit_wavefront_new(
   // Allocate
   edit_wavefront_t* const wavefront = mm_allocator_alloc(mm_allocator,edit_wavefront_t);
   // Offsets
-  const int wavefront_length = hi_max - lo_max + 2; // (+1) for k=0
+  const int wavefront_length = // (+1) for k=0 (plus padding)
+      EWAVEFRONT_PADDING_LO + (hi_max - lo_max + 1) + EWAVEFRONT_PADDING_HI;
   wavefront->offsets_mem = mm_allocator_calloc(
       mm_allocator,wavefront_length,ewf_offset_t,false);
-  wavefront->offsets = wavefront->offsets_mem - lo_max; // Center at k=0
+  wavefront->offsets = wavefront->offsets_mem + EWAVEFRONT_PADDING_LO - lo_max; // Center at k=0
   wavefront->lo_max = lo_max;
   wavefront->hi_max = hi_max;
   wavefront->lo = lo;
@@ -81,17 +86,24 @@ edit_wavefront_segment_t* edit_wavefront_segment_new(
   wavefronts_segment->pattern = pattern;
   wavefronts_segment->pattern_length = pattern_length;
   wavefronts_segment->text_segment = text_segment;
-  // Wavefronts
-  wavefronts_segment->wavefronts = mm_allocator_calloc(mm_allocator,
-      EDIT_WF_POA_MAX_SEGMENT_WAVEFRONTS,edit_wavefront_t*,true);
+  // Wavefronts (allocated on demand)
+  wavefronts_segment->wavefronts = NULL;
+  wavefronts_segment->wavefronts_allocated = 0;
   wavefronts_segment->wf_distance_min = -1;
   wavefronts_segment->wf_distance_max = -1;
   // Control
-  wavefronts_segment->control_mem = mm_allocator_calloc(
-      mm_allocator,pattern_length+text_segment->sequence_length+1,
-      edit_wavefront_control_t,true);
-  wavefronts_segment->control = wavefronts_segment->control_mem + pattern_length; // Center at k=0
+  const int num_diagonals = pattern_length + text_segment->sequence_length + 1;
+  wavefronts_segment->disabled = mm_allocator_calloc(
+      mm_allocator,DIV_CEIL(num_diagonals,64),uint64_t,true);
+  wavefronts_segment->controls = NULL; // Allocated on demand
+  wavefronts_segment->controls_allocated = 0;
+  wavefronts_segment->num_controls = 0;
+  wavefronts_segment->disabled_lo = text_segment->sequence_length + 1; // None
+  wavefronts_segment->disabled_hi = -pattern_length - 1;
   wavefronts_segment->num_valid_offsets = 0;
+  wavefronts_segment->active_distance = -1;
+  // Checkpoints
+  wavefronts_segment->injections = NULL;
   // MM
   wavefronts_segment->mm_allocator = mm_allocator;
   // Return
@@ -101,17 +113,136 @@ void edit_wavefront_segment_delete(
     edit_wavefront_segment_t* const wavefronts_segment) {
   // Parameters
   mm_allocator_t* const mm_allocator = wavefronts_segment->mm_allocator;
-  // Free
-  int i;
-  for (i=0;i<EDIT_WF_POA_MAX_SEGMENT_WAVEFRONTS;++i) {
-    if (wavefronts_segment->wavefronts[i] != NULL) {
-      edit_wavefront_delete(wavefronts_segment->wavefronts[i],mm_allocator);
+  // Free (only live distances)
+  if (wavefronts_segment->wavefronts != NULL) {
+    const int num_wavefronts =
+        wavefronts_segment->wf_distance_max - wavefronts_segment->wf_distance_min + 1;
+    int i;
+    for (i=0;i<num_wavefronts;++i) {
+      if (wavefronts_segment->wavefronts[i] != NULL) {
+        edit_wavefront_delete(wavefronts_segment->wavefronts[i],mm_allocator);
+      }
     }
+    mm_allocator_free(mm_allocator,wavefronts_segment->wavefronts);
   }
-  mm_allocator_free(mm_allocator,wavefronts_segment->wavefronts);
-  mm_allocator_free(mm_allocator,wavefronts_segment->control_mem);
+  if (wavefronts_segment->injections != NULL) vector_delete(wavefronts_segment->injections);
+  if (wavefronts_segment->controls != NULL) mm_allocator_free(mm_allocator,wavefronts_segment->controls);
+  mm_allocator_free(mm_allocator,wavefronts_segment->disabled);
   mm_allocator_free(mm_allocator,wavefronts_segment);
 }
+edit_wavefront_t* edit_wavefront_segment_get_wavefront(
+    edit_wavefront_segment_t* const wavefronts_segment,
+    const int distance) {
+  // Check distance within live range
+  if (distance < wavefronts_segment->wf_distance_min ||
+      distance > wavefronts_segment->wf_distance_max) return NULL;
+  return wavefronts_segment->wavefronts[distance-wavefronts_segment->wf_distance_min];
+}
+void edit_wavefront_segment_set_wavefront(
+    edit_wavefront_segment_t* const wavefronts_segment,
+    const int distance,
+    edit_wavefront_t* const wavefront) {
+  // Parameters
+  mm_allocator_t* const mm_allocator = wavefronts_segment->mm_allocator;
+  // First wavefront
+  if (wavefronts_segment->wavefronts == NULL) {
+    wavefronts_segment->wavefronts = mm_allocator_calloc(mm_allocator,
+        EDIT_WF_POA_SEGMENT_WAVEFRONTS_INIT,edit_wavefront_t*,true);
+    wavefronts_segment->wavefronts_allocated = EDIT_WF_POA_SEGMENT_WAVEFRONTS_INIT;
+    wavefronts_segment->wf_distance_min = distance;
+    wavefronts_segment->wf_distance_max = distance;
+  }
+  // Compute live range (skipping leading freed wavefronts)
+  const int wf_distance_min = wavefronts_segment->wf_distance_min;
+  const int wf_distance_max = wavefronts_segment->wf_distance_max;
+  int live_min = wf_distance_min;
+  while (live_min < distance && live_min <= wf_distance_max &&
+         wavefronts_segment->wavefronts[live_min-wf_distance_min] == NULL) ++live_min;
+  const int range_min = MIN(live_min,distance);
+  const int range_max = MAX(wf_distance_max,distance);
+  // Relocate wavefronts memory (if the range moved or outgrew the allocated memory)
+  if (range_min != wf_distance_min ||
+      range_max-range_min >= wavefronts_segment->wavefronts_allocated) {
+    edit_wavefront_t** const wavefronts_old = wavefronts_segment->wavefronts;
+    const int num_wavefronts_old = wf_distance_max - wf_distance_min + 1;
+    const int num_live = MAX(wf_distance_max-live_min+1,0);
+    const int live_idx_old = live_min - wf_distance_min;
+    const int live_idx = live_min - range_min;
+    if (range_max-range_min >= wavefronts_segment->wavefronts_allocated) {
+      // Grow wavefronts memory
+      int wavefronts_allocated = 2*wavefronts_segment->wavefronts_allocated;
+      while (range_max-range_min >= wavefronts_allocated) wavefronts_allocated *= 2;
+      edit_wavefront_t** const wavefronts = mm_allocator_calloc(mm_allocator,
+          wavefronts_allocated,edit_wavefront_t*,true);
+      memcpy(wavefronts+live_idx,wavefronts_old+live_idx_old,num_live*sizeof(edit_wavefront_t*));
+      mm_allocator_free(mm_allocator,wavefronts_old);
+      wavefronts_segment->wavefronts = wavefronts;
+      wavefronts_segment->wavefronts_allocated = wavefronts_allocated;
+    } else {
+      // Shift wavefronts (in place)
+      memmove(wavefronts_old+live_idx,wavefronts_old+live_idx_old,num_live*sizeof(edit_wavefront_t*));
+      int i;
+      for (i=0;i<live_idx;++i) wavefronts_old[i] = NULL;
+      for (i=live_idx+num_live;i<num_wavefronts_old;++i) wavefronts_old[i] = NULL;
+    }
+    wavefronts_segment->wf_distance_min = range_min;
+  }
+  // Set wavefront
+  wavefronts_segment->wavefronts[distance-range_min] = wavefront;
+  wavefronts_segment->wf_distance_max = range_max;
+}
+edit_wavefront_t* edit_wavefront_segment_new_wavefront(
+    edit_wavefront_segment_t* const wavefronts_segment,
+    const int lo,
+    const int hi) {
+  // Allocate the live diagonals (plus slack) within the segment diagonals
+  const int k_min = -wavefronts_segment->pattern_length;
+  const int k_max = wavefronts_segment->text_segment->sequence_length;
+  return edit_wavefront_new(
+      MAX(MIN(lo,k_max)-EWAVEFRONT_SLACK,k_min),
+      MIN(MAX(hi,k_min)+EWAVEFRONT_SLACK,k_max),
+      lo,hi,wavefronts_segment->mm_allocator);
+}
+void edit_wavefront_segment_reserve_wavefront(
+    edit_wavefront_segment_t* const wavefronts_segment,
+    edit_wavefront_t* const wavefront,
+    const int k) {
+  // Check diagonal already allocated
+  if (wavefront->lo_max <= k && k <= wavefront->hi_max) return;
+  // Parameters
+  mm_allocator_t* const mm_allocator = wavefronts_segment->mm_allocator;
+  const int k_min = -wavefronts_segment->pattern_length;
+  const int k_max = wavefronts_segment->text_segment->sequence_length;
+  const int growth = MAX(EWAVEFRONT_SLACK,(wavefront->hi_max-wavefront->lo_max+1)/2);
+  const int lo_max = (k < wavefront->lo_max) ? MAX(k-growth,k_min) : wavefront->lo_max;
+  const int hi_max = (k > wavefront->hi_max) ? MIN(k+growth,k_max) : wavefront->hi_max;
+  // Allocate wider offsets (and copy the live diagonals)
+  const int wavefront_length =
+      EWAVEFRONT_PADDING_LO + (hi_max - lo_max + 1) + EWAVEFRONT_PADDING_HI;
+  ewf_offset_t* const offsets_mem = mm_allocator_calloc(
+      mm_allocator,wavefront_length,ewf_offset_t,false);
+  ewf_offset_t* const offsets = offsets_mem + EWAVEFRONT_PADDING_LO - lo_max;
+  if (wavefront->lo <= wavefront->hi) {
+    memcpy(offsets+wavefront->lo,wavefront->offsets+wavefront->lo,
+        (wavefront->hi-wavefront->lo+1)*sizeof(ewf_offset_t));
+  }
+  mm_allocator_free(mm_allocator,wavefront->offsets_mem);
+  wavefront->offsets_mem = offsets_mem;
+  wavefront->offsets = offsets;
+  wavefront->lo_max = lo_max;
+  wavefront->hi_max = hi_max;
+}
+void edit_wavefront_segment_free_wavefront(
+    edit_wavefront_segment_t* const wavefronts_segment,
+    const int distance) {
+  // Fetch wavefront
+  edit_wavefront_t* const wavefront =
+      edit_wavefront_segment_get_wavefront(wavefronts_segment,distance);
+  if (wavefront == NULL) return;
+  // Free
+  edit_wavefront_delete(wavefront,wavefronts_segment->mm_allocator);
+  wavefronts_segment->wavefronts[distance-wavefronts_segment->wf_distance_min] = NULL;
+}
 bool edit_wavefront_segment_is_active(
     edit_wavefront_segment_t* const wavefronts_segment,
     const int distance) {
@@ -120,9 +251,90 @@ bool edit_wavefront_segment_is_active(
   // Check if there is any active offset
   if (wavefronts_segment->num_valid_offsets == 0) return false;
   // Check if wavefront for distance is not NULL
-  edit_wavefront_t* const wavefront = wavefronts_segment->wavefronts[distance];
+  edit_wavefront_t* const wavefront =
+      edit_wavefront_segment_get_wavefront(wavefronts_segment,distance);
   return (wavefront != NULL);
 }
+/*
+ * Edit Wavefront-Segments Control
+ */
+edit_wavefront_control_t* edit_wavefront_segment_get_control(
+    edit_wavefront_segment_t* const wavefronts_segment,
+    const int k) {
+  // Check controls
+  if (wavefronts_segment->num_controls == 0) return NULL;
+  // Probe (linear)
+  edit_wavefront_control_t* const controls = wavefronts_segment->controls;
+  const uint32_t mask = wavefronts_segment->controls_allocated - 1;
+  uint32_t pos = EDIT_WF_CONTROL_HASH(k) & mask;
+  while (controls[pos].k != EDIT_WF_CONTROL_EMPTY) {
+    if (controls[pos].k == k) return controls + pos;
+    pos = (pos+1) & mask;
+  }
+  return NULL;
+}
+void edit_wavefront_segment_controls_resize(
+    edit_wavefront_segment_t* const wavefronts_segment,
+    const int controls_allocated) {
+  // Parameters
+  mm_allocator_t* const mm_allocator = wavefronts_segment->mm_allocator;
+  edit_wavefront_control_t* const controls_old = wavefronts_segment->controls;
+  const int controls_allocated_old = wavefronts_segment->controls_allocated;
+  // Allocate
+  edit_wavefront_control_t* const controls = mm_allocator_calloc(
+      mm_allocator,controls_allocated,edit_wavefront_control_t,false);
+  const uint32_t mask = controls_allocated - 1;
+  int i;
+  for (i=0;i<controls_allocated;++i) controls[i].k = EDIT_WF_CONTROL_EMPTY;
+  // Rehash
+  for (i=0;i<controls_allocated_old;++i) {
+    if (controls_old[i].k == EDIT_WF_CONTROL_EMPTY) continue;
+    uint32_t pos = EDIT_WF_CONTROL_HASH(controls_old[i].k) & mask;
+    while (controls[pos].k != EDIT_WF_CONTROL_EMPTY) pos = (pos+1) & mask;
+    controls[pos] = controls_old[i];
+  }
+  if (controls_old != NULL) mm_allocator_free(mm_allocator,controls_old);
+  wavefronts_segment->controls = controls;
+  wavefronts_segment->controls_allocated = controls_allocated;
+}
+edit_wavefront_control_t* edit_wavefront_segment_add_control(
+    edit_wavefront_segment_t* const wavefronts_segment,
+    const int k) {
+  // Check existing control
+  edit_wavefront_control_t* const control =
+      edit_wavefront_segment_get_control(wavefronts_segment,k);
+  if (control != NULL) return control;
+  // Grow (keep load factor below 1/2)
+  if (2*(wavefronts_segment->num_controls+1) > wavefronts_segment->controls_allocated) {
+    const int controls_allocated = (wavefronts_segment->controls_allocated == 0) ?
+        EDIT_WF_POA_SEGMENT_CONTROLS_INIT : 2*wavefronts_segment->controls_allocated;
+    edit_wavefront_segment_controls_resize(wavefronts_segment,controls_allocated);
+  }
+  // Insert
+  edit_wavefront_control_t* const controls = wavefronts_segment->controls;
+  const uint32_t mask = wavefronts_segment->controls_allocated - 1;
+  uint32_t pos = EDIT_WF_CONTROL_HASH(k) & mask;
+  while (controls[pos].k != EDIT_WF_CONTROL_EMPTY) pos = (pos+1) & mask;
+  controls[pos].k = k;
+  controls[pos].connected = false;
+  controls[pos].disabled_distance = -1;
+  ++(wavefronts_segment->num_controls);
+  return controls + pos;
+}
+void edit_wavefront_segment_disable(
+    edit_wavefront_segment_t* const wavefronts_segment,
+    const int k,
+    const int distance) {
+  // Set disabled
+  const int idx = k + wavefronts_segment->pattern_length;
+  wavefronts_segment->disabled[idx>>6] |= (1ull << (idx&63));
+  wavefronts_segment->disabled_lo = MIN(wavefronts_segment->disabled_lo,k);
+  wavefronts_segment->disabled_hi = MAX(wavefronts_segment->disabled_hi,k);
+  // Keep exit distance (to recompute from checkpoints)
+  edit_wavefront_control_t* const control =
+      edit_wavefront_segment_add_control(wavefronts_segment,k);
+  control->disabled_distance = distance;
+}
 /*
  * Wavefront-POA Setup
  */
@@ -131,27 +343,277 @@ edit_wavefront_poa_t* edit_wavefront_poa_new(
   // Allocate
   edit_wavefront_poa_t* const wavefront_poa =
       mm_allocator_alloc(mm_allocator,edit_wavefront_poa_t);
-  // Segment wavefronts
-  wavefront_poa->wavefront_segments = mm_allocator_calloc(mm_allocator,
-      EDIT_WF_POA_MAX_SEGMENTS,edit_wavefront_segment_t*,true);
+  // Segment wavefronts (sized to the text-DAG on alignment)
+  wavefront_poa->wavefront_segments = NULL;
+  wavefront_poa->wavefront_segments_allocated = 0;
+  // Active wavefront-segments
+  wavefront_poa->active_segments = NULL;
+  wavefront_poa->num_active_segments = 0;
+  wavefront_poa->next_active_segments = NULL;
+  wavefront_poa->num_next_active_segments = 0;
+  wavefront_poa->segment_id_to_rank = NULL;
+  // Memory mode
+  wavefront_poa->memory_mode = edit_wavefront_poa_memory_high;
+  wavefront_poa->checkpoint_distance = 0;
+  wavefront_poa->injections_free = vector_new(16,vector_t*);
+  // Alignment span (end-to-end)
+  wavefront_poa->pattern_begin_free = 0;
+  wavefront_poa->pattern_end_free = 0;
+  wavefront_poa->text_begin_free = false;
+  wavefront_poa->text_end_free = false;
+  // Adaptive reduction (disabled)
+  wavefront_poa->reduction = false;
+  wavefront_poa->reduction_min_wavefront_length = 0;
+  wavefront_poa->reduction_max_distance_threshold = 0;
+  wavefront_poa->reduction_text_left = NULL;
+  wavefront_poa->reduction_bounds = NULL;
+  // Cutoff (disabled)
+  wavefront_poa->max_distance = -1;
+  wavefront_poa->xdrop = -1;
+  wavefront_poa->xdrop_best_score = 0;
+  // Parallel (sequential)
+  wavefront_poa->num_threads = 1;
+  wavefront_poa->thread_pool = NULL;
+  wavefront_poa->parallel_wavefront_length = EWAVEFRONT_PARALLEL_LENGTH_DEFAULT;
+  wavefront_poa->tasks = NULL;
+  wavefront_poa->tasks_allocated = 0;
+  // Alignment
+  wavefront_poa->status = edit_wavefront_poa_status_aligned;
+  wavefront_poa->alignment_distance = -1;
+  wavefront_poa->offset_bits = EWAVEFRONT_OFFSET_BITS;
+  wavefront_poa->pattern_packed = NULL;
   // MM
   wavefront_poa->mm_allocator = mm_allocator;
+  wavefront_poa->mm_allocator_wavefronts = mm_allocator_new(EDIT_WF_POA_WAVEFRONTS_MM_SEGMENT);
   // Return
   return wavefront_poa;
 }
-void edit_wavefront_poa_delete(
+void edit_wavefront_poa_set_memory_mode(
+    edit_wavefront_poa_t* const wavefront_poa,
+    const edit_wavefront_poa_memory_t memory_mode,
+    const int checkpoint_distance) {
+  wavefront_poa->memory_mode = memory_mode;
+  wavefront_poa->checkpoint_distance =
+      (memory_mode == edit_wavefront_poa_memory_checkpoint) ? MAX(checkpoint_distance,1) : 0;
+}
+void edit_wavefront_poa_set_ends_free(
+    edit_wavefront_poa_t* const wavefront_poa,
+    const int pattern_begin_free,
+    const int pattern_end_free,
+    const bool text_begin_free,
+    const bool text_end_free) {
+  wavefront_poa->pattern_begin_free = MAX(pattern_begin_free,0);
+  wavefront_poa->pattern_end_free = MAX(pattern_end_free,0);
+  wavefront_poa->text_begin_free = text_begin_free;
+  wavefront_poa->text_end_free = text_end_free;
+}
+void edit_wavefront_poa_set_reduction(
+    edit_wavefront_poa_t* const wavefront_poa,
+    const int min_wavefront_length,
+    const int max_distance_threshold) {
+  wavefront_poa->reduction = true;
+  wavefront_poa->reduction_min_wavefront_length = MAX(min_wavefront_length,1);
+  wavefront_poa->reduction_max_distance_threshold = MAX(max_distance_threshold,0);
+  if (wavefront_poa->reduction_bounds == NULL) {
+    wavefront_poa->reduction_bounds = vector_new(64,int);
+  }
+}
+void edit_wavefront_poa_set_cutoff(
+    edit_wavefront_poa_t* const wavefront_poa,
+    const int max_distance,
+    const int xdrop) {
+  wavefront_poa->max_distance = (max_distance >= 0) ? max_distance : -1;
+  wavefront_poa->xdrop = (xdrop >= 0) ? xdrop : -1;
+}
+void edit_wavefront_poa_set_threads(
+    edit_wavefront_poa_t* const wavefront_poa,
+    const int num_threads) {
+  // Replace thread pool
+  if (wavefront_poa->thread_pool != NULL) thread_pool_delete(wavefront_poa->thread_pool);
+  wavefront_poa->num_threads = MAX(num_threads,1);
+  wavefront_poa->thread_pool = (wavefront_poa->num_threads > 1) ?
+      thread_pool_new(wavefront_poa->num_threads) : NULL;
+}
+void edit_wavefront_poa_set_parallel_wavefront_length(
+    edit_wavefront_poa_t* const wavefront_poa,
+    const int parallel_wavefront_length) {
+  wavefront_poa->parallel_wavefront_length = MAX(parallel_wavefront_length,1);
+}
+void edit_wavefront_poa_tasks_free(
     edit_wavefront_poa_t* const wavefront_poa) {
+  // Check allocated
+  if (wavefront_poa->tasks == NULL) return;
+  // Free tasks
+  int i;
+  for (i=0;i<wavefront_poa->tasks_allocated;++i) {
+    if (wavefront_poa->tasks[i].exits != NULL) vector_delete(wavefront_poa->tasks[i].exits);
+  }
+  mm_allocator_free(wavefront_poa->mm_allocator,wavefront_poa->tasks);
+  wavefront_poa->tasks = NULL;
+  wavefront_poa->tasks_allocated = 0;
+}
+void edit_wavefront_poa_resize(
+    edit_wavefront_poa_t* const wavefront_poa,
+    text_dag_t* const text_dag) {
   // Parameters
   mm_allocator_t* const mm_allocator = wavefront_poa->mm_allocator;
+  const int segments_total = text_dag->segments_total;
+  // Topological ranks
+  wavefront_poa->segment_id_to_rank = text_dag->segment_id_to_rank;
+  wavefront_poa->num_active_segments = 0;
+  wavefront_poa->num_next_active_segments = 0;
+  // Check allocated
+  if (wavefront_poa->wavefront_segments_allocated >= segments_total) return;
   // Free
+  if (wavefront_poa->wavefront_segments != NULL) {
+    mm_allocator_free(mm_allocator,wavefront_poa->reduction_text_left);
+    mm_allocator_free(mm_allocator,wavefront_poa->next_active_segments);
+    mm_allocator_free(mm_allocator,wavefront_poa->active_segments);
+    mm_allocator_free(mm_allocator,wavefront_poa->wavefront_segments);
+  }
+  // Allocate
+  wavefront_poa->wavefront_segments = mm_allocator_calloc(mm_allocator,
+      segments_total,edit_wavefront_segment_t*,true);
+  wavefront_poa->wavefront_segments_allocated = segments_total;
+  wavefront_poa->active_segments = mm_allocator_calloc(mm_allocator,segments_total,int,false);
+  wavefront_poa->next_active_segments = mm_allocator_calloc(mm_allocator,segments_total,int,false);
+  wavefront_poa->reduction_text_left = mm_allocator_calloc(mm_allocator,segments_total,int,false);
+}
+vector_t* edit_wavefront_poa_injections_new(
+    edit_wavefront_poa_t* const wavefront_poa) {
+  // Reuse an injections vector (released by the last clear)
+  vector_t* const injections_free = wavefront_poa->injections_free;
+  const uint64_t num_injections_free = vector_get_used(injections_free);
+  if (num_injections_free > 0) {
+    vector_t* const injections =
+        *vector_get_elm(injections_free,num_injections_free-1,vector_t*);
+    vector_dec_used(injections_free);
+    return injections;
+  }
+  // Allocate
+  return vector_new(4,edit_wavefront_injection_t);
+}
+void edit_wavefront_poa_clear(
+    edit_wavefront_poa_t* const wavefront_poa) {
+#ifndef EWAVEFRONT_OFFSET_32
+  // Wavefront-segments held by the int32 instance
+  if (wavefront_poa->offset_bits == 32) {
+    edit_wavefront_poa_clear_offset32(wavefront_poa);
+    return;
+  }
+#endif
+  // Release wavefront-segments (of the previous alignment)
+  if (wavefront_poa->wavefront_segments == NULL) return;
   int i;
-  for (i=0;i<EDIT_WF_POA_MAX_SEGMENTS;++i) {
-    if (wavefront_poa->wavefront_segments[i] != NULL) {
-      mm_allocator_free(mm_allocator,wavefront_poa->wavefront_segments[i]);
+  for (i=0;i<wavefront_poa->wavefront_segments_allocated;++i) {
+    edit_wavefront_segment_t* const wavefront_segment = wavefront_poa->wavefront_segments[i];
+    if (wavefront_segment == NULL) continue;
+    if (wavefront_segment->injections != NULL) { // Keep injections vector
+      vector_clear(wavefront_segment->injections);
+      vector_insert(wavefront_poa->injections_free,wavefront_segment->injections,vector_t*);
     }
+    wavefront_poa->wavefront_segments[i] = NULL;
   }
-  mm_allocator_free(mm_allocator,wavefront_poa->wavefront_segments);
+  wavefront_poa->num_active_segments = 0;
+  wavefront_poa->num_next_active_segments = 0;
+  // Free wavefronts, controls and segments at once (keeping the memory)
+  mm_allocator_clear(wavefront_poa->mm_allocator_wavefronts);
+}
+void edit_wavefront_poa_delete(
+    edit_wavefront_poa_t* const wavefront_poa) {
+#ifndef EWAVEFRONT_OFFSET_32
+  // Wavefront-segments held by the int32 instance
+  if (wavefront_poa->offset_bits == 32) {
+    edit_wavefront_poa_delete_offset32(wavefront_poa);
+    return;
+  }
+#endif
+  // Parameters
+  mm_allocator_t* const mm_allocator = wavefront_poa->mm_allocator;
+  // Free
+  if (wavefront_poa->wavefront_segments != NULL) {
+    edit_wavefront_poa_clear(wavefront_poa);
+    mm_allocator_free(mm_allocator,wavefront_poa->reduction_text_left);
+    mm_allocator_free(mm_allocator,wavefront_poa->next_active_segments);
+    mm_allocator_free(mm_allocator,wavefront_poa->active_segments);
+    mm_allocator_free(mm_allocator,wavefront_poa->wavefront_segments);
+  }
+  edit_wavefront_poa_tasks_free(wavefront_poa);
+  VECTOR_ITERATE(wavefront_poa->injections_free,injections,n,vector_t*) {
+    vector_delete(*injections);
+  }
+  vector_delete(wavefront_poa->injections_free);
+  mm_allocator_delete(wavefront_poa->mm_allocator_wavefronts);
+  if (wavefront_poa->reduction_bounds != NULL) vector_delete(wavefront_poa->reduction_bounds);
+  if (wavefront_poa->thread_pool != NULL) thread_pool_delete(wavefront_poa->thread_pool);
   mm_allocator_free(mm_allocator,wavefront_poa);
 }
-
-
+/*
+ * Active Wavefront-Segments
+ *   Segments are computed in topological order for each distance, so that
+ *   offsets connected into a next-segment are extended within the same distance.
+ *   Note that a list sorted by rank is already a valid min-heap.
+ */
+void edit_wavefront_poa_active_push(
+    edit_wavefront_poa_t* const wavefront_poa,
+    edit_wavefront_segment_t* const wavefront_segment,
+    const int distance) {
+  // Check already queued
+  if (wavefront_segment->active_distance == distance) return;
+  wavefront_segment->active_distance = distance;
+  // Parameters
+  const int* const rank = wavefront_poa->segment_id_to_rank;
+  int* const heap = wavefront_poa->active_segments;
+  const int segment_idx = wavefront_segment->index;
+  const int segment_rank = rank[segment_idx];
+  // Sift-up
+  int pos = (wavefront_poa->num_active_segments)++;
+  while (pos > 0) {
+    const int parent = (pos-1)/2;
+    if (rank[heap[parent]] <= segment_rank) break;
+    heap[pos] = heap[parent];
+    pos = parent;
+  }
+  heap[pos] = segment_idx;
+}
+int edit_wavefront_poa_active_pop(
+    edit_wavefront_poa_t* const wavefront_poa) {
+  // Parameters
+  const int* const rank = wavefront_poa->segment_id_to_rank;
+  int* const heap = wavefront_poa->active_segments;
+  const int segment_idx = heap[0];
+  const int num_active_segments = --(wavefront_poa->num_active_segments);
+  // Sift-down (last element)
+  const int last_idx = heap[num_active_segments];
+  const int last_rank = rank[last_idx];
+  int pos = 0;
+  while (true) {
+    int child = 2*pos+1;
+    if (child >= num_active_segments) break;
+    if (child+1 < num_active_segments && rank[heap[child+1]] < rank[heap[child]]) ++child;
+    if (last_rank <= rank[heap[child]]) break;
+    heap[pos] = heap[child];
+    pos = child;
+  }
+  heap[pos] = last_idx;
+  // Return
+  return segment_idx;
+}
+void edit_wavefront_poa_active_push_next(
+    edit_wavefront_poa_t* const wavefront_poa,
+    edit_wavefront_segment_t* const wavefront_segment,
+    const int next_distance) {
+  // Segments are popped by increasing rank (the list remains sorted)
+  wavefront_segment->active_distance = next_distance;
+  wavefront_poa->next_active_segments[(wavefront_poa->num_next_active_segments)++] =
+      wavefront_segment->index;
+}
+void edit_wavefront_poa_active_next_distance(
+    edit_wavefront_poa_t* const wavefront_poa) {
+  // Swap active lists
+  int* const active_segments = wavefront_poa->active_segments;
+  wavefront_poa->active_segments = wavefront_poa->next_active_segments;
+  wavefront_poa->num_active_segments = wavefront_poa->num_next_active_segments;
+  wavefront_poa->next_active_segments = active_segments;
+  wavefront_poa->num_next_active_segments = 0;
+}
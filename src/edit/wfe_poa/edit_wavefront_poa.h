@@ -34,7 +34,13 @@
 
 #include "utils/commons.h"
 #include "utils/text_dag.h"
+#include "utils/vector.h"
 #include "system/mm_allocator.h"
+#include "system/thread_pool.h"
+
+#ifdef EWAVEFRONT_OFFSET_32
+#include "edit_wavefront_poa_offset32.h"
+#endif
 
 /*
  * Translate k and offset to coordinates h,v
@@ -50,10 +56,30 @@
 
 #define EWAVEFRONT_OFFSET_NULL -10
 
+#define EWAVEFRONT_PADDING_LO  2  // Diagonals allocated below lo_max (compute reads lo-2)
+#define EWAVEFRONT_PADDING_HI 34  // Diagonals allocated above hi_max (vector kernels run past hi+1)
+#define EWAVEFRONT_SLACK       8  // Diagonals allocated beyond the live range (room to connect/grow)
+
+#define EWAVEFRONT_PARALLEL_LENGTH_DEFAULT 4096 // Shortest wavefront split into chunks (parallel)
+
+/*
+ * Disabled diagonals (bitmap)
+ */
+#define EDIT_WF_SEGMENT_DISABLED(wavefront_segment,k) \
+  (((wavefront_segment)->disabled[((k)+(wavefront_segment)->pattern_length)>>6] >> \
+    (((k)+(wavefront_segment)->pattern_length)&63)) & 1)
+
 /*
  * Individual Edit Wavefront
  */
+#ifdef EWAVEFRONT_OFFSET_32
+typedef int32_t ewf_offset_t;  // Edit Wavefront Offset (long sequences)
+#define EWAVEFRONT_OFFSET_BITS 32
+#else
 typedef int16_t ewf_offset_t;  // Edit Wavefront Offset
+#define EWAVEFRONT_OFFSET_BITS 16
+#endif
+#define EWAVEFRONT_OFFSET16_LENGTH_MAX (INT16_MAX-1) // Longest sequence with int16 offsets (h+1 fits)
 typedef struct {
   int segment_idx;
   int distance;
@@ -61,9 +87,11 @@ typedef struct {
   ewf_offset_t offset;
 } edit_wavefront_locator_t;
 typedef struct {
+  int k;                       // Diagonal (EDIT_WF_CONTROL_EMPTY if the slot is free)
+  bool connected;              // Diagonal connected from a previous segment (at current_wf_begin)
   edit_wavefront_locator_t previous_wf_end;
   edit_wavefront_locator_t current_wf_begin;
-  bool disabled;
+  int disabled_distance;       // Distance at which the diagonal exited the segment (-1 if none)
 } edit_wavefront_control_t;
 typedef struct {
   // Offsets memory
@@ -79,6 +107,10 @@ typedef struct {
 /*
  * Edit Wavefront-Segments
  */
+typedef struct {
+  int distance;                // Distance at which the offset was connected
+  int k;                       // Diagonal connected (at offset 0)
+} edit_wavefront_injection_t;
 typedef struct {
   // Index
   int index;
@@ -86,26 +118,98 @@ typedef struct {
   char* pattern;
   int pattern_length;
   text_dag_segment_t* text_segment;
-  // Wavefront
-  edit_wavefront_t** wavefronts;
-  int wf_distance_min;
-  int wf_distance_max;
+  // Wavefronts (indexed by distance, from wf_distance_min to wf_distance_max)
+  edit_wavefront_t** wavefronts;  // Wavefronts memory (wavefronts[distance-wf_distance_min])
+  int wavefronts_allocated;       // Total wavefront slots allocated
+  int wf_distance_min;            // Lowest distance with a wavefront (-1 if none)
+  int wf_distance_max;            // Highest distance with a wavefront (-1 if none)
   // Control
-  edit_wavefront_control_t* control_mem;
-  edit_wavefront_control_t* control;
+  uint64_t* disabled;             // Diagonals that exited the segment (bitmap indexed by k+pattern_length)
+  edit_wavefront_control_t* controls; // Sparse control of connected/exited diagonals (hashed by k)
+  int controls_allocated;         // Total control slots allocated (power of 2)
+  int num_controls;               // Total control slots used
+  int disabled_lo;                // Lowest diagonal that exited the segment (inclusive)
+  int disabled_hi;                // Highest diagonal that exited the segment (inclusive)
   int num_valid_offsets;
+  int active_distance;            // Last distance the segment was queued as active (-1 if none)
+  // Checkpoints
+  vector_t* injections;           // Offsets connected into the segment (edit_wavefront_injection_t)
   // MM
   mm_allocator_t* mm_allocator;
 } edit_wavefront_segment_t;
 
+/*
+ * Edit Wavefront-POA Parallel Tasks
+ */
+typedef struct {
+  int k;                       // Diagonal reaching the end of the segment
+  ewf_offset_t offset;         // Offset at the end of the segment
+} edit_wavefront_exit_t;
+typedef struct {
+  int segment_idx;             // Segment to extend/compute
+  int k_begin;                 // First diagonal of the chunk (inclusive)
+  int k_end;                   // Last diagonal of the chunk (inclusive)
+  int num_valid_offsets;       // Active offsets left in the chunk (extend)
+  bool alignment_end;          // Chunk reached the end of the alignment (extend)
+  edit_wavefront_locator_t wf_alignment; // End of the alignment (if reached)
+  vector_t* exits;             // Diagonals to connect into next-segments (edit_wavefront_exit_t)
+} edit_wavefront_task_t;
+
 /*
  * Edit Wavefront-POA
  */
+typedef enum {
+  edit_wavefront_poa_memory_high = 0,       // Keep all wavefronts
+  edit_wavefront_poa_memory_checkpoint = 1, // Keep a wavefront every N distances (recompute on backtrace)
+  edit_wavefront_poa_memory_score_only = 2, // Keep the last wavefronts (no backtrace)
+} edit_wavefront_poa_memory_t;
+typedef enum {
+  edit_wavefront_poa_status_aligned = 0,     // Alignment found
+  edit_wavefront_poa_status_not_aligned = 1, // Alignment dropped (max-distance or X-drop cutoff)
+} edit_wavefront_poa_status_t;
 typedef struct {
   // Segment wavefronts
-  edit_wavefront_segment_t** wavefront_segments;
+  edit_wavefront_segment_t** wavefront_segments; // Wavefront-segments (indexed by segment-id)
+  int wavefront_segments_allocated;               // Total wavefront-segment slots allocated
+  // Active wavefront-segments (segment-ids ordered by topological rank)
+  int* active_segments;           // Min-heap (by rank) of segments to compute at the current distance
+  int num_active_segments;        // Total segments in the heap
+  int* next_active_segments;      // Segments still active at the next distance (sorted by rank)
+  int num_next_active_segments;   // Total segments active at the next distance
+  int* segment_id_to_rank;        // Topological rank of each segment (from the text-DAG)
+  // Memory mode
+  edit_wavefront_poa_memory_t memory_mode;
+  int checkpoint_distance;        // Distance between checkpointed wavefronts
+  vector_t* injections_free;      // Injection vectors released by the last clear (vector_t*)
+  // Alignment span (ends-free)
+  int pattern_begin_free;         // Max pattern prefix left unaligned at no cost
+  int pattern_end_free;           // Max pattern suffix left unaligned at no cost
+  bool text_begin_free;           // Alignment may begin anywhere in the text-DAG at no cost
+  bool text_end_free;             // Alignment may end anywhere in the text-DAG at no cost
+  // Adaptive reduction (heuristic)
+  bool reduction;                 // Drop diagonals far behind the best one (across segments)
+  int reduction_min_wavefront_length; // Wavefronts shorter than this are never reduced
+  int reduction_max_distance_threshold; // Max estimated distance-to-end behind the best diagonal
+  int* reduction_text_left;       // Shortest text left from the end of each segment to the sink
+  vector_t* reduction_bounds;     // Max estimated distance-to-end kept at each distance (int)
+  // Cutoff
+  int max_distance;               // Max alignment distance (-1 if unbounded)
+  int xdrop;                      // Max score drop below the best score seen (-1 if disabled)
+  int xdrop_best_score;           // Best score seen (current alignment)
+  // Parallel (segment-parallel and intra-wavefront extend and compute)
+  int num_threads;                // Total threads (1 if sequential)
+  thread_pool_t* thread_pool;     // Worker threads (NULL if sequential)
+  int parallel_wavefront_length;  // Wavefronts at least this long are split into chunks
+  edit_wavefront_task_t* tasks;   // Chunks of the segments computed in parallel
+  int tasks_allocated;            // Total task slots allocated
+  // Alignment
+  edit_wavefront_poa_status_t status; // Status of the last alignment
+  int alignment_distance;         // Edit-distance of the last alignment (-1 if none)
+  int offset_bits;                // Offset width of the engine instance holding the wavefront-segments
+  uint64_t* pattern_packed;       // 2-bit packed pattern (NULL unless both pattern and text-DAG are packed)
   // MM
-  mm_allocator_t* mm_allocator;
+  mm_allocator_t* mm_allocator;            // Setup and per-text-DAG arrays
+  mm_allocator_t* mm_allocator_wavefronts; // Wavefront-segments of the current alignment (cleared at once)
 } edit_wavefront_poa_t;
 
 /*
@@ -132,16 +236,105 @@ edit_wavefront_segment_t* edit_wavefront_segment_new(
 void edit_wavefront_segment_delete(
     edit_wavefront_segment_t* const wavefronts_segment);
 
+edit_wavefront_t* edit_wavefront_segment_get_wavefront(
+    edit_wavefront_segment_t* const wavefronts_segment,
+    const int distance);
+void edit_wavefront_segment_set_wavefront(
+    edit_wavefront_segment_t* const wavefronts_segment,
+    const int distance,
+    edit_wavefront_t* const wavefront);
+
+edit_wavefront_t* edit_wavefront_segment_new_wavefront(
+    edit_wavefront_segment_t* const wavefronts_segment,
+    const int lo,
+    const int hi);
+void edit_wavefront_segment_reserve_wavefront(
+    edit_wavefront_segment_t* const wavefronts_segment,
+    edit_wavefront_t* const wavefront,
+    const int k);
+void edit_wavefront_segment_free_wavefront(
+    edit_wavefront_segment_t* const wavefronts_segment,
+    const int distance);
+
 bool edit_wavefront_segment_is_active(
     edit_wavefront_segment_t* const wavefronts_segment,
     const int distance);
 
+edit_wavefront_control_t* edit_wavefront_segment_get_control(
+    edit_wavefront_segment_t* const wavefronts_segment,
+    const int k);
+edit_wavefront_control_t* edit_wavefront_segment_add_control(
+    edit_wavefront_segment_t* const wavefronts_segment,
+    const int k);
+void edit_wavefront_segment_disable(
+    edit_wavefront_segment_t* const wavefronts_segment,
+    const int k,
+    const int distance);
+
 /*
  * Wavefront-POA Setup
+ *   Wavefront-segments live in a private MM-allocator that is cleared at once between
+ *   alignments (keeping its memory), so that a reused Wavefront-POA stops allocating
+ *   once it has run its largest alignment
  */
 edit_wavefront_poa_t* edit_wavefront_poa_new(
     mm_allocator_t* const mm_allocator);
+void edit_wavefront_poa_set_memory_mode(
+    edit_wavefront_poa_t* const wavefront_poa,
+    const edit_wavefront_poa_memory_t memory_mode,
+    const int checkpoint_distance);
+void edit_wavefront_poa_set_ends_free(
+    edit_wavefront_poa_t* const wavefront_poa,
+    const int pattern_begin_free,
+    const int pattern_end_free,
+    const bool text_begin_free,
+    const bool text_end_free);
+void edit_wavefront_poa_set_reduction(
+    edit_wavefront_poa_t* const wavefront_poa,
+    const int min_wavefront_length,
+    const int max_distance_threshold);
+void edit_wavefront_poa_set_cutoff(
+    edit_wavefront_poa_t* const wavefront_poa,
+    const int max_distance,
+    const int xdrop);
+void edit_wavefront_poa_set_threads(
+    edit_wavefront_poa_t* const wavefront_poa,
+    const int num_threads);
+void edit_wavefront_poa_set_parallel_wavefront_length(
+    edit_wavefront_poa_t* const wavefront_poa,
+    const int parallel_wavefront_length);
+void edit_wavefront_poa_tasks_free(
+    edit_wavefront_poa_t* const wavefront_poa);
+void edit_wavefront_poa_resize(
+    edit_wavefront_poa_t* const wavefront_poa,
+    text_dag_t* const text_dag);
+vector_t* edit_wavefront_poa_injections_new(
+    edit_wavefront_poa_t* const wavefront_poa);
+void edit_wavefront_poa_clear(
+    edit_wavefront_poa_t* const wavefront_poa);
 void edit_wavefront_poa_delete(
     edit_wavefront_poa_t* const wavefront_poa);
+#ifndef EWAVEFRONT_OFFSET_32
+void edit_wavefront_poa_clear_offset32(
+    edit_wavefront_poa_t* const wavefront_poa);
+void edit_wavefront_poa_delete_offset32(
+    edit_wavefront_poa_t* const wavefront_poa);
+#endif
+
+/*
+ * Active Wavefront-Segments
+ */
+void edit_wavefront_poa_active_push(
+    edit_wavefront_poa_t* const wavefront_poa,
+    edit_wavefront_segment_t* const wavefront_segment,
+    const int distance);
+int edit_wavefront_poa_active_pop(
+    edit_wavefront_poa_t* const wavefront_poa);
+void edit_wavefront_poa_active_push_next(
+    edit_wavefront_poa_t* const wavefront_poa,
+    edit_wavefront_segment_t* const wavefront_segment,
+    const int next_distance);
+void edit_wavefront_poa_active_next_distance(
+    edit_wavefront_poa_t* const wavefront_poa);
 
 #endif /* EDIT_WAVEFRONT_H_ */
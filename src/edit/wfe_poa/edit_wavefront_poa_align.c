@@ -28,136 +28,303 @@
  * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
  */
 
-#include "edit_wavefront_poa.h"
+#include "edit_wavefront_poa_align.h"
 #include "edit_wavefront_poa_connect.h"
 #include "edit_wavefront_poa_extend.h"
 #include "edit_wavefront_poa_display.h"
 #include "edit_wavefront_poa_backtrace.h"
+#include "edit_wavefront_poa_compute.h"
+#include "edit_wavefront_poa_reduction.h"
+#include "edit_wavefront_poa_parallel.h"
 #include "alignment/cigar.h"
 
 /*
  * Wavefront-POA compute next wavefront
  */
-void edit_wavefront_segment_compute_next(
+edit_wavefront_t* edit_wavefront_segment_compute_next_allocate(
     edit_wavefront_segment_t* const wavefront_segment,
     const int distance) {
   // Fetch previous wavefront
-  edit_wavefront_t* const wavefront = wavefront_segment->wavefronts[distance-1];
-  if (wavefront_segment->num_valid_offsets == 0) return; // Check wavefront active
-  // Fetch current wavefront
+  edit_wavefront_t* const wavefront =
+      edit_wavefront_segment_get_wavefront(wavefront_segment,distance-1);
+  if (wavefront_segment->num_valid_offsets == 0) return NULL; // Check wavefront active
+  // Allocate next wavefront
   const int hi = wavefront->hi;
   const int lo = wavefront->lo;
   edit_wavefront_t* const next_wavefront =
-      edit_wavefront_new(-wavefront_segment->pattern_length,
-          wavefront_segment->text_segment->sequence_length,
-          lo-1,hi+1,wavefront_segment->mm_allocator); // TODO Proper boundary check on new WF
-  wavefront_segment->wavefronts[distance] = next_wavefront;
-  wavefront_segment->wf_distance_max = distance;
-  // Fetch offsets
+      edit_wavefront_segment_new_wavefront(wavefront_segment,lo-1,hi+1);
+  edit_wavefront_segment_set_wavefront(wavefront_segment,distance,next_wavefront);
+  // Null the diagonals around the wavefront (padded, so no loop peeling is needed)
   ewf_offset_t* const offsets = wavefront->offsets;
-  ewf_offset_t* const next_offsets = next_wavefront->offsets;
-  // Loop peeling (k=lo-1)
-  if (offsets[lo] < 0) {
-    // next_offsets[lo-1] = EWAVEFRONT_OFFSET_NULL;
-    // wavefront_segment->control[lo-1].disabled = true;
+  offsets[lo-2] = EWAVEFRONT_OFFSET_NULL;
+  offsets[lo-1] = EWAVEFRONT_OFFSET_NULL;
+  offsets[hi+1] = EWAVEFRONT_OFFSET_NULL;
+  offsets[hi+2] = EWAVEFRONT_OFFSET_NULL;
+  // Trim ends
+  if (lo-1 < -wavefront_segment->pattern_length || offsets[lo] < 0) { // Out of the segment (v>pattern_length)
     next_wavefront->lo = lo;
-  } else {
-    next_offsets[lo-1] = offsets[lo];
-    ++(wavefront_segment->num_valid_offsets);
-  }
-  // Loop peeling (k=lo)
-  const ewf_offset_t bottom_upper_del = ((lo+1) <= hi) ? offsets[lo+1] : EWAVEFRONT_OFFSET_NULL;
-  next_offsets[lo] = MAX(offsets[lo]+1,bottom_upper_del);
-  // Compute next wavefront starting point
-  int k;
-  #pragma GCC ivdep
-  for (k=lo+1;k<=hi-1;++k) {
-    /*
-     * const int del = offsets[k+1]; // Upper
-     * const int sub = offsets[k] + 1; // Mid
-     * const int ins = offsets[k-1] + 1; // Lower
-     * next_offsets[k] = MAX(sub,ins,del); // MAX
-     */
-    const ewf_offset_t max_ins_sub = MAX(offsets[k],offsets[k-1]) + 1;
-    next_offsets[k] = MAX(max_ins_sub,offsets[k+1]);
-  }
-  // Loop peeling (k=hi)
-  const ewf_offset_t top_lower_ins = (lo <= (hi-1)) ? offsets[hi-1] : EWAVEFRONT_OFFSET_NULL;
-  next_offsets[hi] = MAX(offsets[hi],top_lower_ins) + 1;
-  // Loop peeling (k=hi+1)
-  if (offsets[hi]+1 < 0) {
-    // next_offsets[hi+1] = EWAVEFRONT_OFFSET_NULL;
-    // wavefront_segment->control[hi+1].disabled = true;
+  }
+  if (hi+1 > wavefront_segment->text_segment->sequence_length || offsets[hi]+1 < 0) { // Out of the segment (h>text_length)
     next_wavefront->hi = hi;
-  } else {
-    next_offsets[hi+1] = offsets[hi] + 1;
-    ++(wavefront_segment->num_valid_offsets);
+  }
+  return next_wavefront;
+}
+void edit_wavefront_segment_compute_next_offsets(
+    edit_wavefront_segment_t* const wavefront_segment,
+    const int distance,
+    const int k_begin,
+    const int k_end) {
+  // Fetch wavefronts
+  edit_wavefront_t* const wavefront =
+      edit_wavefront_segment_get_wavefront(wavefront_segment,distance-1);
+  edit_wavefront_t* const next_wavefront =
+      edit_wavefront_segment_get_wavefront(wavefront_segment,distance);
+  // Compute next wavefront
+  edit_wavefront_compute_kernel_f const compute_kernel = edit_wavefront_compute_kernel_get();
+  compute_kernel(wavefront->offsets,next_wavefront->offsets,k_begin,k_end);
+}
+void edit_wavefront_segment_compute_next(
+    edit_wavefront_segment_t* const wavefront_segment,
+    const int distance) {
+  // Allocate next wavefront (if active)
+  if (edit_wavefront_segment_compute_next_allocate(wavefront_segment,distance) == NULL) return;
+  // Compute next wavefront (k=lo-1 and k=hi+1 included)
+  edit_wavefront_t* const wavefront =
+      edit_wavefront_segment_get_wavefront(wavefront_segment,distance-1);
+  edit_wavefront_segment_compute_next_offsets(
+      wavefront_segment,distance,wavefront->lo-1,wavefront->hi+1);
+}
+/*
+ * Wavefront-POA release wavefronts (no longer needed)
+ */
+void edit_wavefront_segment_release(
+    edit_wavefront_poa_t* const wavefront_poa,
+    edit_wavefront_segment_t* const wavefront_segment,
+    const int distance) {
+  switch (wavefront_poa->memory_mode) {
+    case edit_wavefront_poa_memory_checkpoint:
+      // Keep checkpoints (the rest is recomputed on backtrace)
+      if (distance % wavefront_poa->checkpoint_distance == 0) break;
+      edit_wavefront_segment_free_wavefront(wavefront_segment,distance);
+      break;
+    case edit_wavefront_poa_memory_score_only:
+      // Keep the last extended wavefront (unless the segment is no longer active)
+      edit_wavefront_segment_free_wavefront(wavefront_segment,distance-1);
+      if (wavefront_segment->num_valid_offsets == 0) {
+        edit_wavefront_segment_free_wavefront(wavefront_segment,distance);
+      }
+      break;
+    default:
+      break;
   }
 }
 /*
  * Wavefront-POA edit distance
  */
-void edit_wavefront_poa_align_init(
+void edit_wavefront_poa_align_seed(
     edit_wavefront_poa_t* const wavefront_poa,
     char* const pattern,
     const int pattern_length,
-    text_dag_t* const text_dag) {
-  // Fetch first segment
-  text_dag_segment_t* const segment = text_dag->segments_ts[0];
-  // Set initial wavefront-segment
+    text_dag_t* const text_dag,
+    const int segment_idx) {
+  // Set wavefront-segment
+  text_dag_segment_t* const segment = text_dag->segments_ts[segment_idx];
   edit_wavefront_segment_t* const wavefront_segment = edit_wavefront_segment_new(
-      pattern,pattern_length,segment,wavefront_poa->mm_allocator);
-  wavefront_segment->index = 0;
-  wavefront_poa->wavefront_segments[0] = wavefront_segment;
-  wavefront_segment->wf_distance_min = 0;
-  wavefront_segment->wf_distance_max = 0;
+      pattern,pattern_length,segment,wavefront_poa->mm_allocator_wavefronts);
+  wavefront_segment->index = segment_idx;
+  wavefront_poa->wavefront_segments[segment_idx] = wavefront_segment;
   // Set initial wavefront
-  edit_wavefront_t* const wavefront = edit_wavefront_new(
-      -pattern_length,segment->sequence_length,0,0,wavefront_poa->mm_allocator);
-  wavefront_segment->wavefronts[0] = wavefront;
-  // Set initial offset
-  wavefront->offsets[0] = 0;
-  wavefront_segment->num_valid_offsets = 1;
+  //   Diagonals below 0 skip the pattern prefix (h=0,v=-k) and diagonals above
+  //   0 skip the segment prefix (h=k,v=0). End-to-end only has k=0. The pattern
+  //   prefix is only skipped from source segments (independent of how the
+  //   text-DAG splits its sequences into segments)
+  const bool source_segment = (segment->prev_total == 0);
+  const int lo = (source_segment) ? -MIN(wavefront_poa->pattern_begin_free,pattern_length) : 0;
+  const int hi = (wavefront_poa->text_begin_free) ? segment->sequence_length : 0;
+  edit_wavefront_t* const wavefront =
+      edit_wavefront_segment_new_wavefront(wavefront_segment,lo,hi);
+  edit_wavefront_segment_set_wavefront(wavefront_segment,0,wavefront);
+  // Set initial offsets
+  int k;
+  for (k=lo;k<=hi;++k) {
+    wavefront->offsets[k] = MAX(k,0);
+  }
+  wavefront_segment->num_valid_offsets = hi - lo + 1;
+  // Set initial active segment
+  edit_wavefront_poa_active_push(wavefront_poa,wavefront_segment,0);
 }
-void edit_wavefront_poa_align(
+void edit_wavefront_poa_align_init(
     edit_wavefront_poa_t* const wavefront_poa,
     char* const pattern,
     const int pattern_length,
+    text_dag_t* const text_dag) {
+  // Size wavefront-segments to the text-DAG (releasing the previous alignment)
+  edit_wavefront_poa_clear(wavefront_poa);
+  edit_wavefront_poa_resize(wavefront_poa,text_dag);
+  // Pack the pattern (if the text-DAG is packed)
+  wavefront_poa->pattern_packed = NULL;
+  if (text_dag->packed_sequences != NULL) {
+    uint64_t* const pattern_packed = mm_allocator_calloc(wavefront_poa->mm_allocator_wavefronts,
+        TEXT_DAG_PACKED_WORDS(pattern_length),uint64_t,false);
+    if (text_dag_sequence_pack(pattern,pattern_length,pattern_packed)) {
+      wavefront_poa->pattern_packed = pattern_packed;
+    } else {
+      mm_allocator_free(wavefront_poa->mm_allocator_wavefronts,pattern_packed);
+    }
+  }
+  // Set initial wavefront-segments
+  //   First segment (source of the topologically sorted text-DAG), or
+  //   every segment if the alignment can begin anywhere in the text-DAG
+  const int num_seeds = (wavefront_poa->text_begin_free) ? text_dag->segments_total : 1;
+  int rank;
+  for (rank=0;rank<num_seeds;++rank) {
+    edit_wavefront_poa_align_seed(wavefront_poa,
+        pattern,pattern_length,text_dag,text_dag->rank_to_segment_id[rank]);
+  }
+  // Set adaptive reduction
+  if (wavefront_poa->reduction) {
+    edit_wavefront_poa_reduction_init(wavefront_poa,text_dag);
+  }
+  // Set cutoff
+  wavefront_poa->xdrop_best_score = 0;
+  wavefront_poa->status = edit_wavefront_poa_status_aligned;
+  wavefront_poa->alignment_distance = -1;
+  wavefront_poa->offset_bits = EWAVEFRONT_OFFSET_BITS;
+}
+bool edit_wavefront_poa_align_extend(
+    edit_wavefront_poa_t* const wavefront_poa,
     text_dag_t* const text_dag,
-    cigar_t* const cigar) {
+    const int distance,
+    edit_wavefront_locator_t* const wf_alignment) {
+  // Segment-parallel extend
+  if (wavefront_poa->thread_pool != NULL) {
+    return edit_wavefront_poa_parallel_extend(wavefront_poa,text_dag,distance,wf_alignment);
+  }
+  // Parameters
+  edit_wavefront_segment_t** const wavefront_segments = wavefront_poa->wavefront_segments;
+  // Extend active segments (in topological order)
+  while (wavefront_poa->num_active_segments > 0) {
+    const int segment_idx = edit_wavefront_poa_active_pop(wavefront_poa);
+    edit_wavefront_segment_t* const wavefront_segment = wavefront_segments[segment_idx];
+    if (!edit_wavefront_segment_is_active(wavefront_segment,distance)) continue; // Check active
+    // Extend diagonally each wavefront point
+    const bool alignment_end = edit_wavefront_poa_segment_extend(
+        wavefront_poa,wavefront_segment,text_dag,distance,wf_alignment,NULL);
+    // Check exit condition
+    if (alignment_end) {
+      // DEBUG: To display the WFA
+      // edit_wavefront_poa_print(stderr,wavefront_poa,text_dag,distance);
+      wavefront_poa->alignment_distance = distance;
+      return true;
+    }
+    // Keep extended segment (candidate for the next distance)
+    edit_wavefront_poa_active_push_next(wavefront_poa,wavefront_segment,distance+1);
+  }
+  // No End-of-Alignment
+  return false;
+}
+void edit_wavefront_poa_align_compute_next(
+    edit_wavefront_poa_t* const wavefront_poa,
+    const int distance) {
+  // Segment-parallel compute
+  if (wavefront_poa->thread_pool != NULL) {
+    edit_wavefront_poa_parallel_compute_next(wavefront_poa,distance);
+    return;
+  }
   // Parameters
-  const int segments_total = text_dag->segments_total;
   edit_wavefront_segment_t** const wavefront_segments = wavefront_poa->wavefront_segments;
+  int* const next_active_segments = wavefront_poa->next_active_segments;
+  const int num_extended_segments = wavefront_poa->num_next_active_segments;
+  // Compute next wavefronts of the extended segments (dropping inactive ones)
+  int i, num_next_active_segments = 0;
+  for (i=0;i<num_extended_segments;++i) {
+    const int segment_idx = next_active_segments[i];
+    edit_wavefront_segment_t* const wavefront_segment = wavefront_segments[segment_idx];
+    edit_wavefront_segment_compute_next(wavefront_segment,distance+1);
+    if (wavefront_segment->num_valid_offsets > 0) {
+      next_active_segments[num_next_active_segments++] = segment_idx;
+    } else {
+      wavefront_segment->active_distance = -1;
+    }
+    edit_wavefront_segment_release(wavefront_poa,wavefront_segment,distance);
+  }
+  wavefront_poa->num_next_active_segments = num_next_active_segments;
+  // Next distance
+  edit_wavefront_poa_active_next_distance(wavefront_poa);
+}
+bool edit_wavefront_poa_align_cutoff(
+    edit_wavefront_poa_t* const wavefront_poa,
+    const int distance) {
+  // Check max-distance
+  if (wavefront_poa->max_distance >= 0 && distance >= wavefront_poa->max_distance) return true;
+  if (wavefront_poa->xdrop < 0) return false;
+  // Parameters
+  edit_wavefront_segment_t** const wavefront_segments = wavefront_poa->wavefront_segments;
+  int* const next_active_segments = wavefront_poa->next_active_segments;
+  const int num_next_active_segments = wavefront_poa->num_next_active_segments;
+  // Compute the furthest pattern position reached (across the extended segments)
+  int i, k, max_v = 0;
+  for (i=0;i<num_next_active_segments;++i) {
+    edit_wavefront_t* const wavefront = edit_wavefront_segment_get_wavefront(
+        wavefront_segments[next_active_segments[i]],distance);
+    if (wavefront == NULL) continue;
+    const ewf_offset_t* const offsets = wavefront->offsets;
+    for (k=wavefront->lo;k<=wavefront->hi;++k) {
+      if (offsets[k] >= 0) max_v = MAX(max_v,EWAVEFRONT_V(k,offsets[k]));
+    }
+  }
+  // Check X-drop
+  //   Score (match=+1, edit=-1) lower-bounded as v-2*distance (at least v-distance matches)
+  const int score = max_v - 2*distance;
+  if (score > wavefront_poa->xdrop_best_score) {
+    wavefront_poa->xdrop_best_score = score;
+    return false;
+  }
+  return (wavefront_poa->xdrop_best_score - score > wavefront_poa->xdrop);
+}
+bool edit_wavefront_poa_offsets16_fit(
+    const int pattern_length,
+    text_dag_t* const text_dag) {
+  // Check pattern and text-segments (offsets reach h+1 on compute)
+  if (pattern_length > EWAVEFRONT_OFFSET16_LENGTH_MAX) return false;
+  int i;
+  for (i=0;i<text_dag->segments_total;++i) {
+    if (text_dag->segments_ts[i]->sequence_length > EWAVEFRONT_OFFSET16_LENGTH_MAX) return false;
+  }
+  return true;
+}
+void edit_wavefront_poa_align(
+    edit_wavefront_poa_t* const wavefront_poa,
+    char* const pattern,
+    const int pattern_length,
+    text_dag_t* const text_dag,
+    cigar_t* const cigar) {
+#ifndef EWAVEFRONT_OFFSET_32
+  // Select engine instance (int16 offsets unless the sequences are too long)
+  if (!edit_wavefront_poa_offsets16_fit(pattern_length,text_dag)) {
+    edit_wavefront_poa_align_offset32(wavefront_poa,pattern,pattern_length,text_dag,cigar);
+    return;
+  }
+#endif
   // Set initial wavefront-segment
   edit_wavefront_poa_align_init(wavefront_poa,pattern,pattern_length,text_dag);
   // Compute wavefronts for increasing distance (across wavefront-segment)
   edit_wavefront_locator_t wf_alignment;
-  bool aligned = false;
   int distance = 0;
-  while (!aligned) {
-    // Check all active segments
-    int segment_idx;
-    for (segment_idx=0;segment_idx<segments_total;++segment_idx) {
-      edit_wavefront_segment_t* const wavefront_segment = wavefront_segments[segment_idx];
-      if (edit_wavefront_segment_is_active(wavefront_segment,distance)) { // Check active
-        // Extend diagonally each wavefront point
-        const bool alignment_end = edit_wavefront_poa_segment_extend(
-            wavefront_poa,wavefront_segment,text_dag,distance,&wf_alignment);
-        // Check exit condition
-        if (alignment_end) {
-          // DEBUG: To display the WFA
-          // edit_wavefront_poa_print(stderr,wavefront_poa,text_dag,distance);
-          aligned = true;
-          break;
-        }
-        // Compute next wavefront starting point
-        edit_wavefront_segment_compute_next(wavefront_segment,distance+1);
-      }
+  while (!edit_wavefront_poa_align_extend(wavefront_poa,text_dag,distance,&wf_alignment)) {
+    if (edit_wavefront_poa_align_cutoff(wavefront_poa,distance)) {
+      wavefront_poa->status = edit_wavefront_poa_status_not_aligned;
+      cigar_clear(cigar);
+      return;
     }
-    // Increase distance
+    if (wavefront_poa->reduction) edit_wavefront_poa_reduce(wavefront_poa,distance);
+    edit_wavefront_poa_align_compute_next(wavefront_poa,distance);
     ++distance;
   }
-  // Backtrace wavefronts
+  // Backtrace wavefronts (if kept)
+  if (wavefront_poa->memory_mode == edit_wavefront_poa_memory_score_only) {
+    cigar_clear(cigar);
+    return;
+  }
   edit_wavefront_poa_backtrace(wavefront_poa,&wf_alignment,cigar);
 }
-
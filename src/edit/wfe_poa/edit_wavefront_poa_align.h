@@ -32,15 +32,81 @@
 #define EDIT_WAVEFRONT_ALIGN_H_
 
 #include "edit_wavefront_poa.h"
+#include "alignment/cigar.h"
+
+/*
+ * Wavefront-POA compute next wavefront
+ *   Split into allocation (uses the MM-allocator, sets the next lo/hi) and computation
+ *   of the offsets of the diagonals [k_begin,k_end] (thread-safe across segments and
+ *   across disjoint diagonal ranges)
+ */
+edit_wavefront_t* edit_wavefront_segment_compute_next_allocate(
+    edit_wavefront_segment_t* const wavefront_segment,
+    const int distance);
+void edit_wavefront_segment_compute_next_offsets(
+    edit_wavefront_segment_t* const wavefront_segment,
+    const int distance,
+    const int k_begin,
+    const int k_end);
+void edit_wavefront_segment_compute_next(
+    edit_wavefront_segment_t* const wavefront_segment,
+    const int distance);
+void edit_wavefront_segment_release(
+    edit_wavefront_poa_t* const wavefront_poa,
+    edit_wavefront_segment_t* const wavefront_segment,
+    const int distance);
 
 /*
  * Wavefront-POA edit distance
+ *   Each distance extends the active segments in topological order (extend) and
+ *   then computes their next wavefronts (compute_next). Alignments whose pattern or
+ *   text-segments do not fit int16 offsets run on the int32 instance of the engine.
+ *   Ends-free alignments seed the initial wavefront (align_seed) with the free
+ *   pattern/text prefixes, and finish on the first offset within the free suffixes.
+ *   Adaptive reduction (if set) trims the extended wavefronts before compute_next.
+ *   The search is dropped (status not-aligned, empty CIGAR) once the max-distance is
+ *   reached or the X-drop score falls too far below the best one seen (align_cutoff).
+ *   With more than one thread set, extend and compute_next run segment-parallel
  */
+void edit_wavefront_poa_align_seed(
+    edit_wavefront_poa_t* const wavefront_poa,
+    char* const pattern,
+    const int pattern_length,
+    text_dag_t* const text_dag,
+    const int segment_idx);
+void edit_wavefront_poa_align_init(
+    edit_wavefront_poa_t* const wavefront_poa,
+    char* const pattern,
+    const int pattern_length,
+    text_dag_t* const text_dag);
+bool edit_wavefront_poa_align_extend(
+    edit_wavefront_poa_t* const wavefront_poa,
+    text_dag_t* const text_dag,
+    const int distance,
+    edit_wavefront_locator_t* const wf_alignment);
+void edit_wavefront_poa_align_compute_next(
+    edit_wavefront_poa_t* const wavefront_poa,
+    const int distance);
+bool edit_wavefront_poa_align_cutoff(
+    edit_wavefront_poa_t* const wavefront_poa,
+    const int distance);
+
+bool edit_wavefront_poa_offsets16_fit(
+    const int pattern_length,
+    text_dag_t* const text_dag);
 void edit_wavefront_poa_align(
     edit_wavefront_poa_t* const wavefront_poa,
     char* const pattern,
     const int pattern_length,
     text_dag_t* const text_dag,
     cigar_t* const cigar);
+#ifndef EWAVEFRONT_OFFSET_32
+void edit_wavefront_poa_align_offset32(
+    edit_wavefront_poa_t* const wavefront_poa,
+    char* const pattern,
+    const int pattern_length,
+    text_dag_t* const text_dag,
+    cigar_t* const cigar);
+#endif
 
 #endif /* EDIT_WAVEFRONT_ALIGN_H_ */
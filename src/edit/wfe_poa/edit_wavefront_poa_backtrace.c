@@ -29,33 +29,72 @@
  */
 
 #include "edit_wavefront_poa_backtrace.h"
+#include "edit_wavefront_poa_checkpoint.h"
 
 /*
  * Backtrace Wavefront-POA
  */
-void edit_wavefront_poa_backtrace_segment(
+bool edit_wavefront_poa_backtrace_seeded(
+    edit_wavefront_poa_t* const wavefront_poa,
+    edit_wavefront_segment_t* const wavefront_segment,
+    const int k) {
+  // Check initial diagonal (see edit_wavefront_poa_align_seed)
+  const bool source_segment = (wavefront_segment->text_segment->prev_total == 0);
+  if (!source_segment && !wavefront_poa->text_begin_free) return false;
+  const int lo = (source_segment) ?
+      -MIN(wavefront_poa->pattern_begin_free,wavefront_segment->pattern_length) : 0;
+  const int hi = (wavefront_poa->text_begin_free) ? wavefront_segment->text_segment->sequence_length : 0;
+  return (lo <= k && k <= hi);
+}
+edit_wavefront_locator_t* edit_wavefront_poa_backtrace_begin(
+    edit_wavefront_poa_t* const wavefront_poa,
+    edit_wavefront_segment_t* const wavefront_segment,
+    const int distance,
+    const int k,
+    edit_wavefront_locator_t* const wf_seed,
+    edit_wavefront_locator_t* const wf_none) {
+  // Check begin of the alignment (initial offsets)
+  if (distance == 0 && edit_wavefront_poa_backtrace_seeded(wavefront_poa,wavefront_segment,k)) {
+    wf_seed->k = k;
+    wf_seed->offset = MAX(k,0);
+    return wf_seed;
+  }
+  // Fetch begin-location (only diagonals connected from a previous segment have one)
+  edit_wavefront_control_t* const control =
+      edit_wavefront_segment_get_control(wavefront_segment,k);
+  return (control != NULL && control->connected) ? &control->current_wf_begin : wf_none;
+}
+bool edit_wavefront_poa_backtrace_segment(
+    edit_wavefront_poa_t* const wavefront_poa,
     edit_wavefront_segment_t* const wavefront_segment,
     edit_wavefront_locator_t* const wf_loc,
     cigar_t* const cigar) {
   // Parameters wavefront
-  edit_wavefront_locator_t wf_init = {
-      .segment_idx = 0,
+  edit_wavefront_locator_t wf_seed = {
+      .segment_idx = wavefront_segment->index,
       .distance = 0,
       .k = 0,
       .offset = 0,
   };
-  edit_wavefront_control_t* const control = wavefront_segment->control;
+  edit_wavefront_locator_t wf_none = {
+      .segment_idx = -1,
+      .distance = -1,
+      .k = 0,
+      .offset = 0,
+  };
   int distance = wf_loc->distance;
   int k = wf_loc->k;
   int offset = wf_loc->offset;
-  edit_wavefront_locator_t* wf_begin = (wf_loc->segment_idx!=0) ? &(control[k].current_wf_begin) : &wf_init;
+  edit_wavefront_locator_t* wf_begin = edit_wavefront_poa_backtrace_begin(
+      wavefront_poa,wavefront_segment,distance,k,&wf_seed,&wf_none);
   // Parameters CIGAR
   char* const cigar_operations = cigar->operations;
   int cigar_offset = cigar->begin_offset;
   // Backtrace
   while (wf_begin->distance!=distance || wf_begin->k!=k) {
     // Fetch
-    const edit_wavefront_t* const wavefront = wavefront_segment->wavefronts[distance-1];
+    const edit_wavefront_t* const wavefront =
+        edit_wavefront_poa_checkpoint_get_wavefront(wavefront_poa,wavefront_segment,distance-1);
     const ewf_offset_t* const offsets = wavefront->offsets;
     // Traceback operation
     const ewf_offset_t offset_del =
@@ -88,7 +127,8 @@ void edit_wavefront_poa_backtrace_segment(
       --offset;
     }
     // Reload begin-location
-    wf_begin = (wf_loc->segment_idx!=0) ? &(control[k].current_wf_begin) : &wf_init;
+    wf_begin = edit_wavefront_poa_backtrace_begin(
+        wavefront_poa,wavefront_segment,distance,k,&wf_seed,&wf_none);
   }
   // Account for last run of matches
   const int leading_matches = offset - wf_begin->offset;
@@ -96,10 +136,17 @@ void edit_wavefront_poa_backtrace_segment(
   for (i=0;i<leading_matches;++i) {
     cigar_operations[--cigar_offset] = 'M';
   }
-  // Return wf-location (previous segment)
-  *wf_loc = control[k].previous_wf_end;
-  // Close CIGAR
   cigar->begin_offset = cigar_offset;
+  // Check begin of the alignment
+  if (wf_begin == &wf_seed) {
+    // Add unaligned prefix (ends-free)
+    cigar_add_leading_insertion(cigar,MAX(k,0)); // Segment prefix
+    cigar_add_leading_deletion(cigar,MAX(-k,0)); // Pattern prefix
+    return true;
+  }
+  // Return wf-location (previous segment)
+  *wf_loc = edit_wavefront_segment_get_control(wavefront_segment,k)->previous_wf_end;
+  return false;
 }
 void edit_wavefront_poa_backtrace(
     edit_wavefront_poa_t* const wavefront_poa,
@@ -107,23 +154,23 @@ void edit_wavefront_poa_backtrace(
     cigar_t* const cigar) {
   // Parameters
   edit_wavefront_segment_t** const wavefront_segments = wavefront_poa->wavefront_segments;
+  edit_wavefront_segment_t* const end_segment = wavefront_segments[wf_alignment->segment_idx];
   // Clear CIGAR
   cigar_clear(cigar);
-  // Backtrace from alignment-segment back to the beginning of the text-DAG
+  // Add unaligned suffix (ends-free)
+  const int end_h = EWAVEFRONT_H(wf_alignment->k,wf_alignment->offset);
+  const int end_v = EWAVEFRONT_V(wf_alignment->k,wf_alignment->offset);
+  cigar_add_leading_deletion(cigar,end_segment->pattern_length-end_v); // Pattern suffix
+  cigar_add_leading_insertion(cigar,end_segment->text_segment->sequence_length-end_h); // Segment suffix
+  // Backtrace from alignment-segment back to the beginning of the alignment
   edit_wavefront_locator_t wf_loc = *wf_alignment;
-  int segment_idx;
+  bool alignment_begin;
   do {
     // Backtrace segment-region
-    segment_idx = wf_loc.segment_idx;
-    edit_wavefront_poa_backtrace_segment(wavefront_segments[segment_idx],&wf_loc,cigar);
+    const int segment_idx = wf_loc.segment_idx;
+    alignment_begin = edit_wavefront_poa_backtrace_segment(
+        wavefront_poa,wavefront_segments[segment_idx],&wf_loc,cigar);
     // Add segment-idx to CIGAR
     cigar_add_segment(cigar,segment_idx);
-  } while (segment_idx > 0);
+  } while (!alignment_begin);
 }
-
-
-
-
-
-
-
@@ -0,0 +1,135 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of WFPOA.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Partial Order Alignment Wavefront Alignment (WFPOA)
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: Batch alignment of many patterns against one text-DAG
+ */
+
+#include "edit_wavefront_poa_batch.h"
+#include "edit_wavefront_poa_align.h"
+
+/*
+ * Batch task arguments
+ */
+typedef struct {
+  edit_wavefront_poa_batch_t* wavefront_poa_batch;
+  char** patterns;
+  const int* pattern_lengths;
+  text_dag_t* text_dag;
+  cigar_t* cigars;
+  int* distances;
+} edit_wavefront_batch_args_t;
+
+/*
+ * Setup
+ */
+edit_wavefront_poa_batch_t* edit_wavefront_poa_batch_new(
+    const int num_threads) {
+  // Allocate
+  edit_wavefront_poa_batch_t* const wavefront_poa_batch = malloc(sizeof(edit_wavefront_poa_batch_t));
+  // Threads
+  wavefront_poa_batch->num_threads = MAX(num_threads,1);
+  wavefront_poa_batch->thread_pool = (wavefront_poa_batch->num_threads > 1) ?
+      thread_pool_new(wavefront_poa_batch->num_threads) : NULL;
+  // Per-thread alignment
+  const int num_poas = wavefront_poa_batch->num_threads;
+  wavefront_poa_batch->mm_allocators = malloc(num_poas*sizeof(mm_allocator_t*));
+  wavefront_poa_batch->wavefront_poas = malloc(num_poas*sizeof(edit_wavefront_poa_t*));
+  int i;
+  for (i=0;i<num_poas;++i) {
+    wavefront_poa_batch->mm_allocators[i] = mm_allocator_new(BUFFER_SIZE_8M);
+    wavefront_poa_batch->wavefront_poas[i] = edit_wavefront_poa_new(wavefront_poa_batch->mm_allocators[i]);
+  }
+  // Return
+  return wavefront_poa_batch;
+}
+void edit_wavefront_poa_batch_delete(
+    edit_wavefront_poa_batch_t* const wavefront_poa_batch) {
+  // Free per-thread alignment
+  int i;
+  for (i=0;i<wavefront_poa_batch->num_threads;++i) {
+    edit_wavefront_poa_delete(wavefront_poa_batch->wavefront_poas[i]);
+    mm_allocator_delete(wavefront_poa_batch->mm_allocators[i]);
+  }
+  free(wavefront_poa_batch->wavefront_poas);
+  free(wavefront_poa_batch->mm_allocators);
+  // Free threads
+  if (wavefront_poa_batch->thread_pool != NULL) thread_pool_delete(wavefront_poa_batch->thread_pool);
+  free(wavefront_poa_batch);
+}
+/*
+ * Batch alignment
+ */
+void edit_wavefront_poa_batch_align_task(
+    void* const args,
+    const int task_idx,
+    const int thread_idx) {
+  // Parameters
+  edit_wavefront_batch_args_t* const batch_args = (edit_wavefront_batch_args_t*)args;
+  edit_wavefront_poa_t* const wavefront_poa =
+      batch_args->wavefront_poa_batch->wavefront_poas[thread_idx];
+  // Align pattern (with the thread Wavefront-POA)
+  edit_wavefront_poa_align(wavefront_poa,
+      batch_args->patterns[task_idx],batch_args->pattern_lengths[task_idx],
+      batch_args->text_dag,batch_args->cigars+task_idx);
+  if (batch_args->distances != NULL) {
+    batch_args->distances[task_idx] = wavefront_poa->alignment_distance;
+  }
+  // Release the wavefronts (keeping the Wavefront-POA)
+  edit_wavefront_poa_clear(wavefront_poa);
+}
+void edit_wavefront_poa_align_batch(
+    edit_wavefront_poa_batch_t* const wavefront_poa_batch,
+    char** const patterns,
+    const int* const pattern_lengths,
+    const int num_patterns,
+    text_dag_t* const text_dag,
+    cigar_t* const cigars,
+    int* const distances) {
+  // Freeze the text-DAG (shared read-only by all threads)
+  text_dag_t* const text_dag_frozen = (text_dag->frozen) ? text_dag : text_dag_freeze(text_dag);
+  // Align patterns
+  edit_wavefront_batch_args_t batch_args = {
+      .wavefront_poa_batch = wavefront_poa_batch,
+      .patterns = patterns,
+      .pattern_lengths = pattern_lengths,
+      .text_dag = text_dag_frozen,
+      .cigars = cigars,
+      .distances = distances,
+  };
+  if (wavefront_poa_batch->thread_pool != NULL) {
+    thread_pool_run(wavefront_poa_batch->thread_pool,
+        edit_wavefront_poa_batch_align_task,&batch_args,num_patterns);
+  } else {
+    int i;
+    for (i=0;i<num_patterns;++i) {
+      edit_wavefront_poa_batch_align_task(&batch_args,i,0);
+    }
+  }
+  // Free
+  if (text_dag_frozen != text_dag) text_dag_delete(text_dag_frozen);
+}
@@ -0,0 +1,80 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignments Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignments Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: Batch alignment of many patterns against one text-DAG
+ */
+
+#ifndef EDIT_WAVEFRONT_BATCH_H_
+#define EDIT_WAVEFRONT_BATCH_H_
+
+#include "edit_wavefront_poa.h"
+#include "alignment/cigar.h"
+
+/*
+ * Edit Wavefront-POA Batch
+ *   Aligns patterns against a read-only text-DAG on a thread pool. Each thread keeps
+ *   its own MM-allocator and Wavefront-POA, reused across patterns and batches
+ *   (configure them with the Wavefront-POA setters, e.g. ends-free or cutoff)
+ */
+typedef struct {
+  // Threads
+  int num_threads;                        // Total threads
+  thread_pool_t* thread_pool;             // Worker threads (NULL if sequential)
+  // Per-thread alignment
+  mm_allocator_t** mm_allocators;         // MM-Allocator of each thread
+  edit_wavefront_poa_t** wavefront_poas;  // Wavefront-POA of each thread
+} edit_wavefront_poa_batch_t;
+
+/*
+ * Setup
+ */
+edit_wavefront_poa_batch_t* edit_wavefront_poa_batch_new(
+    const int num_threads);
+void edit_wavefront_poa_batch_delete(
+    edit_wavefront_poa_batch_t* const wavefront_poa_batch);
+
+/*
+ * Batch alignment
+ *   Aligns each pattern into its CIGAR (allocated by the caller) and returns its
+ *   distance (-1 if not aligned). The text-DAG is frozen for the batch (unless it
+ *   already is), and the CIGARs refer to the segment ids of the given text-DAG
+ */
+void edit_wavefront_poa_batch_align_task(
+    void* const args,
+    const int task_idx,
+    const int thread_idx);
+void edit_wavefront_poa_align_batch(
+    edit_wavefront_poa_batch_t* const wavefront_poa_batch,
+    char** const patterns,
+    const int* const pattern_lengths,
+    const int num_patterns,
+    text_dag_t* const text_dag,
+    cigar_t* const cigars,
+    int* const distances);
+
+#endif /* EDIT_WAVEFRONT_BATCH_H_ */
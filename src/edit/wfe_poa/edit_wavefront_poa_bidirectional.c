@@ -0,0 +1,351 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of WFPOA.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Partial Order Alignment Wavefront Alignment (WFPOA)
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ */
+
+#include "edit_wavefront_poa_bidirectional.h"
+#include "edit_wavefront_poa_align.h"
+
+/*
+ * Constants
+ */
+#ifndef EDIT_WF_POA_BIDIRECTIONAL_BASE_DISTANCE
+#define EDIT_WF_POA_BIDIRECTIONAL_BASE_DISTANCE 250 // Align directly below this distance
+#endif
+
+/*
+ * Overlap forward/backward wavefronts
+ */
+void edit_wavefront_poa_bidirectional_range(
+    edit_wavefront_segment_t* const wavefront_segment,
+    const int distance,
+    int* const k_min,
+    int* const k_max) {
+  // Parameters
+  const int text_length = wavefront_segment->text_segment->sequence_length;
+  const int pattern_length = wavefront_segment->pattern_length;
+  edit_wavefront_t* const wavefront =
+      edit_wavefront_segment_get_wavefront(wavefront_segment,distance);
+  // Diagonals reached (or dominated by diagonals that exited the segment)
+  int lo = wavefront_segment->disabled_lo - distance;
+  int hi = wavefront_segment->disabled_hi + distance;
+  if (wavefront != NULL) {
+    lo = MIN(lo,wavefront->lo);
+    hi = MAX(hi,wavefront->hi);
+  }
+  *k_min = MAX(lo,-pattern_length);
+  *k_max = MIN(hi,text_length);
+}
+void edit_wavefront_poa_bidirectional_reach(
+    edit_wavefront_segment_t* const wavefront_segment,
+    const int distance,
+    const int k_min,
+    const int k_max,
+    int* const reach) {
+  // Parameters
+  const int text_length = wavefront_segment->text_segment->sequence_length;
+  const int pattern_length = wavefront_segment->pattern_length;
+  edit_wavefront_t* const wavefront =
+      edit_wavefront_segment_get_wavefront(wavefront_segment,distance);
+  int k, exit_distance;
+  for (k=k_min;k<=k_max;++k) reach[k-k_min] = -1;
+  // Diagonals within reach of an exit cover the whole diagonal. Once a diagonal exits at
+  // distance d, its neighbours at distance d+|k-k_exit| would lie past the segment end
+  // (or at the segment end, deleting pattern characters)
+  exit_distance = distance + 1;
+  for (k=MAX(k_min-distance,wavefront_segment->disabled_lo);k<=k_max;++k) {
+    exit_distance = MIN(exit_distance+1,distance+1);
+    if (EDIT_WF_SEGMENT_DISABLED(wavefront_segment,k)) {
+      exit_distance = MIN(exit_distance,
+          edit_wavefront_segment_get_control(wavefront_segment,k)->disabled_distance);
+    }
+    if (k >= k_min && exit_distance <= distance) {
+      reach[k-k_min] = MIN(text_length,pattern_length+k);
+    }
+  }
+  exit_distance = distance + 1;
+  for (k=MIN(k_max+distance,wavefront_segment->disabled_hi);k>=k_min;--k) {
+    exit_distance = MIN(exit_distance+1,distance+1);
+    if (EDIT_WF_SEGMENT_DISABLED(wavefront_segment,k)) {
+      exit_distance = MIN(exit_distance,
+          edit_wavefront_segment_get_control(wavefront_segment,k)->disabled_distance);
+    }
+    if (k <= k_max && exit_distance <= distance) {
+      reach[k-k_min] = MIN(text_length,pattern_length+k);
+    }
+  }
+  // Offsets reached
+  if (wavefront == NULL) return;
+  const int lo = MAX(k_min,wavefront->lo);
+  const int hi = MIN(k_max,wavefront->hi);
+  for (k=lo;k<=hi;++k) {
+    const int offset = wavefront->offsets[k];
+    if (reach[k-k_min] >= 0 || offset < 0) continue;
+    if (offset > text_length || offset-k > pattern_length) continue;
+    reach[k-k_min] = offset;
+  }
+}
+bool edit_wavefront_poa_bidirectional_overlap(
+    edit_wavefront_poa_t* const wavefront_poa,
+    const int distance,
+    edit_wavefront_poa_t* const wavefront_poa_opposite,
+    const int distance_opposite,
+    const bool forward,
+    edit_wavefront_breakpoint_t* const breakpoint) {
+  // Parameters
+  mm_allocator_t* const mm_allocator = wavefront_poa->mm_allocator;
+  const int num_segments = MIN(wavefront_poa->wavefront_segments_allocated,
+      wavefront_poa_opposite->wavefront_segments_allocated);
+  int segment_idx, k;
+  // Check segments reached in both directions
+  for (segment_idx=0;segment_idx<num_segments;++segment_idx) {
+    // Fetch wavefront-segments (same segment-idx in both directions)
+    edit_wavefront_segment_t* const wavefront_segment =
+        wavefront_poa->wavefront_segments[segment_idx];
+    edit_wavefront_segment_t* const wavefront_segment_opposite =
+        wavefront_poa_opposite->wavefront_segments[segment_idx];
+    if (wavefront_segment == NULL || wavefront_segment_opposite == NULL) continue;
+    const int text_length = wavefront_segment->text_segment->sequence_length;
+    const int pattern_length = wavefront_segment->pattern_length;
+    // Intersect diagonals (opposite diagonal k' is diagonal text_length-pattern_length-k')
+    int k_min, k_max, k_min_opposite, k_max_opposite;
+    edit_wavefront_poa_bidirectional_range(wavefront_segment,distance,&k_min,&k_max);
+    edit_wavefront_poa_bidirectional_range(
+        wavefront_segment_opposite,distance_opposite,&k_min_opposite,&k_max_opposite);
+    k_min = MAX(k_min,text_length-pattern_length-k_max_opposite);
+    k_max = MIN(k_max,text_length-pattern_length-k_min_opposite);
+    if (k_min > k_max) continue;
+    k_min_opposite = text_length-pattern_length-k_max;
+    k_max_opposite = text_length-pattern_length-k_min;
+    // Compute reach in both directions
+    const int num_diagonals = k_max - k_min + 1;
+    int* const reach = mm_allocator_calloc(mm_allocator,2*num_diagonals,int,false);
+    int* const reach_opposite = reach + num_diagonals;
+    edit_wavefront_poa_bidirectional_reach(
+        wavefront_segment,distance,k_min,k_max,reach);
+    edit_wavefront_poa_bidirectional_reach(
+        wavefront_segment_opposite,distance_opposite,k_min_opposite,k_max_opposite,reach_opposite);
+    // Check overlap
+    for (k=k_min;k<=k_max;++k) {
+      const int h = reach[k-k_min];
+      const int h_opposite = reach_opposite[k_max-k];
+      if (h < 0 || h_opposite < 0 || h + h_opposite < text_length) continue;
+      // Breakpoint (in forward coordinates)
+      breakpoint->segment_idx = segment_idx;
+      breakpoint->offset = (forward) ? h : text_length - h;
+      breakpoint->v = (forward) ? h - k : pattern_length - (h - k);
+      breakpoint->distance = distance + distance_opposite;
+      mm_allocator_free(mm_allocator,reach);
+      return true;
+    }
+    mm_allocator_free(mm_allocator,reach);
+  }
+  // No overlap
+  return false;
+}
+bool edit_wavefront_poa_bidirectional_breakpoint(
+    mm_allocator_t* const mm_allocator,
+    char* const pattern,
+    char* const pattern_reversed,
+    const int pattern_length,
+    text_dag_t* const text_dag,
+    text_dag_t* const text_dag_reversed,
+    edit_wavefront_breakpoint_t* const breakpoint) {
+  // Allocate forward/backward wavefronts (keeping only the last wavefronts)
+  edit_wavefront_poa_t* const wavefront_poa_forward = edit_wavefront_poa_new(mm_allocator);
+  edit_wavefront_poa_t* const wavefront_poa_reverse = edit_wavefront_poa_new(mm_allocator);
+  edit_wavefront_poa_set_memory_mode(wavefront_poa_forward,edit_wavefront_poa_memory_score_only,0);
+  edit_wavefront_poa_set_memory_mode(wavefront_poa_reverse,edit_wavefront_poa_memory_score_only,0);
+  edit_wavefront_poa_align_init(wavefront_poa_forward,pattern,pattern_length,text_dag);
+  edit_wavefront_poa_align_init(wavefront_poa_reverse,pattern_reversed,pattern_length,text_dag_reversed);
+  // Compute wavefronts in both directions until they overlap
+  edit_wavefront_locator_t wf_alignment;
+  bool overlap = false;
+  int distance_forward = 0, distance_reverse = 0;
+  while (true) {
+    // Forward
+    if (edit_wavefront_poa_align_extend(wavefront_poa_forward,
+        text_dag,distance_forward,&wf_alignment)) break; // End reached (no breakpoint)
+    if (distance_reverse > 0) {
+      overlap = edit_wavefront_poa_bidirectional_overlap(
+          wavefront_poa_forward,distance_forward,
+          wavefront_poa_reverse,distance_reverse-1,true,breakpoint);
+      if (overlap) break;
+    }
+    edit_wavefront_poa_align_compute_next(wavefront_poa_forward,distance_forward);
+    ++distance_forward;
+    // Reverse
+    if (edit_wavefront_poa_align_extend(wavefront_poa_reverse,
+        text_dag_reversed,distance_reverse,&wf_alignment)) break; // End reached (no breakpoint)
+    overlap = edit_wavefront_poa_bidirectional_overlap(
+        wavefront_poa_reverse,distance_reverse,
+        wavefront_poa_forward,distance_forward-1,false,breakpoint);
+    if (overlap) break;
+    edit_wavefront_poa_align_compute_next(wavefront_poa_reverse,distance_reverse);
+    ++distance_reverse;
+  }
+  // Free
+  edit_wavefront_poa_delete(wavefront_poa_reverse);
+  edit_wavefront_poa_delete(wavefront_poa_forward);
+  // Return
+  return overlap;
+}
+/*
+ * Bidirectional alignment
+ */
+void edit_wavefront_poa_bidirectional_prepend(
+    cigar_t* const cigar,
+    cigar_t* const cigar_half,
+    const int* const segment_ids) {
+  // Parameters
+  char* const operations = cigar_half->operations;
+  int* const half_segment_ids = cigar_half->segment_ids;
+  int i;
+  // Drop the leading segment of the CIGAR (shared with the last segment of the half)
+  for (i=cigar_half->end_offset-1;i>=cigar_half->begin_offset;--i) {
+    if (operations[i] != CIGAR_OP_SEGMENT) continue;
+    if (cigar->begin_offset < cigar->end_offset &&
+        cigar->operations[cigar->begin_offset] == CIGAR_OP_SEGMENT &&
+        cigar->segment_ids[cigar->begin_offset] == segment_ids[half_segment_ids[i]]) {
+      ++(cigar->begin_offset);
+    }
+    break;
+  }
+  // Prepend operations (translating segment-ids)
+  for (i=cigar_half->end_offset-1;i>=cigar_half->begin_offset;--i) {
+    const char operation = operations[i];
+    if (operation != CIGAR_OP_SEGMENT) {
+      cigar->operations[--(cigar->begin_offset)] = operation;
+    } else {
+      cigar_add_segment(cigar,segment_ids[half_segment_ids[i]]);
+    }
+  }
+}
+void edit_wavefront_poa_bidirectional_align_range(
+    mm_allocator_t* const mm_allocator,
+    char* const pattern,
+    const int pattern_begin,
+    const int pattern_end,
+    text_dag_t* const text_dag,
+    const int segment_begin,
+    const int offset_begin,
+    const int segment_end,
+    const int offset_end,
+    cigar_t* const cigar) {
+  // Extract text-DAG in between (and reversed)
+  int* const segment_ids = malloc(text_dag->segments_total*sizeof(int));
+  text_dag_t* const text_dag_range = text_dag_subgraph(
+      text_dag,segment_begin,offset_begin,segment_end,offset_end,segment_ids);
+  text_dag_t* const text_dag_reversed = text_dag_reverse(text_dag_range);
+  int text_length = 0, i;
+  for (i=0;i<text_dag_range->segments_total;++i) {
+    text_length += text_dag_range->segments_ts[i]->sequence_length;
+  }
+  // Extract pattern in between (and reversed)
+  const int pattern_length = pattern_end - pattern_begin;
+  char* const pattern_buffer = mm_allocator_calloc(mm_allocator,2*(pattern_length+2),char,false);
+  char* const pattern_range = pattern_buffer + 1;
+  char* const pattern_reversed = pattern_buffer + pattern_length + 3;
+  for (i=0;i<pattern_length;++i) {
+    pattern_range[i] = pattern[pattern_begin+i];
+    pattern_reversed[i] = pattern[pattern_end-1-i];
+  }
+  pattern_range[-1] = 'Y'; pattern_range[pattern_length] = 'Y';
+  pattern_reversed[-1] = 'Y'; pattern_reversed[pattern_length] = 'Y';
+  // Find breakpoint
+  edit_wavefront_breakpoint_t breakpoint;
+  const bool overlap = edit_wavefront_poa_bidirectional_breakpoint(mm_allocator,
+      pattern_range,pattern_reversed,pattern_length,text_dag_range,text_dag_reversed,&breakpoint);
+  if (!overlap || breakpoint.distance <= EDIT_WF_POA_BIDIRECTIONAL_BASE_DISTANCE) {
+    // Base case (align directly)
+    cigar_t cigar_range;
+    cigar_allocate(&cigar_range,pattern_length+text_dag_range->segments_total,text_length,mm_allocator);
+    edit_wavefront_poa_t* const wavefront_poa = edit_wavefront_poa_new(mm_allocator);
+    edit_wavefront_poa_align(wavefront_poa,pattern_range,pattern_length,text_dag_range,&cigar_range);
+    edit_wavefront_poa_bidirectional_prepend(cigar,&cigar_range,segment_ids);
+    edit_wavefront_poa_delete(wavefront_poa);
+    cigar_free(&cigar_range,mm_allocator);
+  } else {
+    // Translate breakpoint
+    const int breakpoint_segment = segment_ids[breakpoint.segment_idx];
+    const int breakpoint_offset = breakpoint.offset +
+        ((breakpoint_segment==segment_begin) ? offset_begin : 0);
+    const int breakpoint_v = pattern_begin + breakpoint.v;
+    // Align right half
+    edit_wavefront_poa_bidirectional_align_range(mm_allocator,pattern,
+        breakpoint_v,pattern_end,text_dag,breakpoint_segment,breakpoint_offset,
+        segment_end,offset_end,cigar);
+    // Align left half
+    edit_wavefront_poa_bidirectional_align_range(mm_allocator,pattern,
+        pattern_begin,breakpoint_v,text_dag,segment_begin,offset_begin,
+        breakpoint_segment,breakpoint_offset,cigar);
+  }
+  // Free
+  mm_allocator_free(mm_allocator,pattern_buffer);
+  text_dag_delete(text_dag_reversed);
+  text_dag_delete(text_dag_range);
+  free(segment_ids);
+}
+void edit_wavefront_poa_align_bidirectional(
+    edit_wavefront_poa_t* const wavefront_poa,
+    char* const pattern,
+    const int pattern_length,
+    text_dag_t* const text_dag,
+    cigar_t* const cigar) {
+  // Ends-free alignments run unidirectional (the reverse search has no fixed begin)
+  if (wavefront_poa->pattern_begin_free > 0 || wavefront_poa->pattern_end_free > 0 ||
+      wavefront_poa->text_begin_free || wavefront_poa->text_end_free) {
+    edit_wavefront_poa_align(wavefront_poa,pattern,pattern_length,text_dag,cigar);
+    return;
+  }
+#ifndef EWAVEFRONT_OFFSET_32
+  // Select engine instance (int16 offsets unless the sequences are too long)
+  if (!edit_wavefront_poa_offsets16_fit(pattern_length,text_dag)) {
+    edit_wavefront_poa_align_bidirectional_offset32(
+        wavefront_poa,pattern,pattern_length,text_dag,cigar);
+    return;
+  }
+#endif
+  // Parameters
+  const int segments_total = text_dag->segments_total;
+  const int segment_source = text_dag->rank_to_segment_id[0];
+  const int segment_sink = text_dag->rank_to_segment_id[segments_total-1];
+  // Clear CIGAR
+  cigar_clear(cigar);
+  // Align whole pattern against the whole text-DAG
+  edit_wavefront_poa_bidirectional_align_range(wavefront_poa->mm_allocator,
+      pattern,0,pattern_length,text_dag,segment_source,0,
+      segment_sink,text_dag->segments_ts[segment_sink]->sequence_length,cigar);
+  // Compute distance
+  int distance = 0, i;
+  for (i=cigar->begin_offset;i<cigar->end_offset;++i) {
+    const char operation = cigar->operations[i];
+    distance += (operation=='X' || operation=='I' || operation=='D');
+  }
+  wavefront_poa->alignment_distance = distance;
+}
@@ -0,0 +1,68 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignments Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignments Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ */
+
+#ifndef EDIT_WAVEFRONT_BIDIRECTIONAL_H_
+#define EDIT_WAVEFRONT_BIDIRECTIONAL_H_
+
+#include "edit_wavefront_poa.h"
+#include "alignment/cigar.h"
+
+/*
+ * Breakpoint (forward and backward wavefronts overlap)
+ */
+typedef struct {
+  int segment_idx;   // Segment (text-DAG)
+  int offset;        // Text offset within the segment
+  int v;             // Pattern offset
+  int distance;      // Total distance (forward+backward)
+} edit_wavefront_breakpoint_t;
+
+/*
+ * Bidirectional Wavefront-POA edit distance
+ *   Aligns forward from the source and backward from the sink (over the reversed text-DAG)
+ *   until the wavefronts overlap, and recurses on both halves (keeping only the last
+ *   wavefronts of each direction)
+ */
+void edit_wavefront_poa_align_bidirectional(
+    edit_wavefront_poa_t* const wavefront_poa,
+    char* const pattern,
+    const int pattern_length,
+    text_dag_t* const text_dag,
+    cigar_t* const cigar);
+#ifndef EWAVEFRONT_OFFSET_32
+void edit_wavefront_poa_align_bidirectional_offset32(
+    edit_wavefront_poa_t* const wavefront_poa,
+    char* const pattern,
+    const int pattern_length,
+    text_dag_t* const text_dag,
+    cigar_t* const cigar);
+#endif
+
+#endif /* EDIT_WAVEFRONT_BIDIRECTIONAL_H_ */
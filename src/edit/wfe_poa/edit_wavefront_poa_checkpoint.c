@@ -0,0 +1,191 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of WFPOA.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Partial Order Alignment Wavefront Alignment (WFPOA)
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ */
+
+#include "edit_wavefront_poa_checkpoint.h"
+#include "edit_wavefront_poa_align.h"
+#include "edit_wavefront_poa_extend.h"
+#include "edit_wavefront_poa_reduction.h"
+
+/*
+ * Recompute Wavefront-Segment from checkpoint
+ *   Replays the wavefronts of a segment between checkpoints (memory-checkpoint mode).
+ *   Offsets connected from previous segments are taken from the segment injections,
+ *   and diagonals are closed according to the distance they exited the segment.
+ */
+void edit_wavefront_poa_checkpoint_inject(
+    edit_wavefront_segment_t* const wavefront_segment,
+    const int distance,
+    const int k) {
+  // Fetch wavefront
+  edit_wavefront_t* wavefront =
+      edit_wavefront_segment_get_wavefront(wavefront_segment,distance);
+  if (wavefront == NULL) {
+    wavefront = edit_wavefront_segment_new_wavefront(wavefront_segment,k,k);
+    edit_wavefront_segment_set_wavefront(wavefront_segment,distance,wavefront);
+  } else {
+    edit_wavefront_segment_reserve_wavefront(wavefront_segment,wavefront,k);
+  }
+  // Set offset
+  wavefront->offsets[k] = 0;
+  // Fill gap in the wavefront (if any)
+  int j;
+  if (k > wavefront->hi) {
+    for (j=wavefront->hi+1;j<k;++j) {
+      wavefront->offsets[j] = EWAVEFRONT_OFFSET_NULL;
+    }
+    wavefront->hi = k;
+  } else if (k < wavefront->lo) {
+    for (j=k+1;j<wavefront->lo;++j) {
+      wavefront->offsets[j] = EWAVEFRONT_OFFSET_NULL;
+    }
+    wavefront->lo = k;
+  }
+}
+int edit_wavefront_poa_checkpoint_extend(
+    edit_wavefront_segment_t* const wavefront_segment,
+    const int distance) {
+  // Parameters
+  text_dag_segment_t* const text_segment = wavefront_segment->text_segment;
+  const char* const pattern = wavefront_segment->pattern;
+  const int pattern_length = wavefront_segment->pattern_length;
+  const char* const text = text_segment->sequence;
+  const int text_length = text_segment->sequence_length;
+  // Fetch wavefront
+  edit_wavefront_t* const wavefront =
+      edit_wavefront_segment_get_wavefront(wavefront_segment,distance);
+  ewf_offset_t* const offsets = wavefront->offsets;
+  // Extend diagonally each wavefront point
+  int k, num_valid_offsets = 0;
+  for (k=wavefront->lo;k<=wavefront->hi;++k) {
+    // Check diagonal disabled (at a previous distance)
+    if (EDIT_WF_SEGMENT_DISABLED(wavefront_segment,k) &&
+        edit_wavefront_segment_get_control(wavefront_segment,k)->disabled_distance < distance) {
+      offsets[k] = EWAVEFRONT_OFFSET_NULL;
+      continue;
+    }
+    // Locate offset and extend
+    int v = EWAVEFRONT_V(k,offsets[k]);
+    int h = EWAVEFRONT_H(k,offsets[k]);
+    if (h < 0 || h > text_length || v < 0 || v > pattern_length) { // Null/out-of-bounds offset
+      offsets[k] = EWAVEFRONT_OFFSET_NULL;
+      continue;
+    }
+    const int num_matches = edit_wavefront_poa_extend_matches(
+        pattern,v,pattern_length,text,h,text_length);
+    offsets[k] += num_matches;
+    v += num_matches;
+    h += num_matches;
+    // Close offsets connected to next-segments (already connected)
+    if (text[h] == 'X' && text_segment->next_total > 0) {
+      offsets[k] = EWAVEFRONT_OFFSET_NULL;
+      continue;
+    }
+    ++num_valid_offsets;
+  }
+  // Return active offsets
+  return num_valid_offsets;
+}
+void edit_wavefront_poa_checkpoint_recompute(
+    edit_wavefront_poa_t* const wavefront_poa,
+    edit_wavefront_segment_t* const wavefront_segment,
+    const int distance) {
+  // Parameters
+  const int checkpoint_distance = wavefront_poa->checkpoint_distance;
+  const int checkpoint = (distance/checkpoint_distance)*checkpoint_distance;
+  int d;
+  // Free wavefronts recomputed for the block above (already backtraced)
+  const int block_above = checkpoint + checkpoint_distance;
+  for (d=block_above+1;d<block_above+checkpoint_distance;++d) {
+    edit_wavefront_segment_free_wavefront(wavefront_segment,d);
+  }
+  // Fetch checkpoint
+  int num_valid_offsets = 0;
+  edit_wavefront_t* const wavefront =
+      edit_wavefront_segment_get_wavefront(wavefront_segment,checkpoint);
+  if (wavefront != NULL) {
+    int k;
+    for (k=wavefront->lo;k<=wavefront->hi;++k) {
+      if (wavefront->offsets[k] >= 0) ++num_valid_offsets;
+    }
+  }
+  // Locate first injection after the checkpoint
+  int num_injections = 0, next_injection = 0;
+  edit_wavefront_injection_t* injections = NULL;
+  if (wavefront_segment->injections != NULL) {
+    num_injections = vector_get_used(wavefront_segment->injections);
+    injections = vector_get_mem(wavefront_segment->injections,edit_wavefront_injection_t);
+    int hi = num_injections;
+    while (next_injection < hi) { // Lower-bound (injections sorted by distance)
+      const int mid = (next_injection+hi)/2;
+      if (injections[mid].distance <= checkpoint) next_injection = mid+1;
+      else hi = mid;
+    }
+  }
+  // Recompute wavefronts up to distance
+  for (d=checkpoint+1;d<=distance;++d) {
+    edit_wavefront_segment_free_wavefront(wavefront_segment,d);
+    // Compute next wavefront
+    if (num_valid_offsets > 0) {
+      wavefront_segment->num_valid_offsets = num_valid_offsets;
+      edit_wavefront_segment_compute_next(wavefront_segment,d);
+    }
+    // Connected offsets
+    for (;next_injection<num_injections && injections[next_injection].distance==d;++next_injection) {
+      edit_wavefront_poa_checkpoint_inject(wavefront_segment,d,injections[next_injection].k);
+    }
+    // Extend
+    if (edit_wavefront_segment_get_wavefront(wavefront_segment,d) != NULL) {
+      num_valid_offsets = edit_wavefront_poa_checkpoint_extend(wavefront_segment,d);
+      // Replay reduction
+      if (wavefront_poa->reduction && num_valid_offsets > 0) {
+        num_valid_offsets -= edit_wavefront_segment_reduce(wavefront_poa,wavefront_segment,
+            d,edit_wavefront_poa_reduction_get_bound(wavefront_poa,d));
+      }
+    } else {
+      num_valid_offsets = 0;
+    }
+  }
+}
+/*
+ * Accessors
+ */
+edit_wavefront_t* edit_wavefront_poa_checkpoint_get_wavefront(
+    edit_wavefront_poa_t* const wavefront_poa,
+    edit_wavefront_segment_t* const wavefront_segment,
+    const int distance) {
+  // Fetch wavefront
+  edit_wavefront_t* const wavefront =
+      edit_wavefront_segment_get_wavefront(wavefront_segment,distance);
+  if (wavefront != NULL ||
+      wavefront_poa->memory_mode != edit_wavefront_poa_memory_checkpoint) return wavefront;
+  // Recompute from checkpoint
+  edit_wavefront_poa_checkpoint_recompute(wavefront_poa,wavefront_segment,distance);
+  return edit_wavefront_segment_get_wavefront(wavefront_segment,distance);
+}
@@ -0,0 +1,170 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of WFPOA.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Partial Order Alignment Wavefront Alignment (WFPOA)
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ */
+
+#include "edit_wavefront_poa_compute.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define EDIT_WF_COMPUTE_X86
+#endif
+
+/*
+ * Vector lanes (int16 or int32 offsets)
+ */
+#ifdef EWAVEFRONT_OFFSET_32
+#define EDIT_WF_LANES_128 4
+#define EDIT_WF_LANES_256 8
+#define EDIT_WF_LANES_512 16
+#define EWF_MM_SET1    _mm_set1_epi32
+#define EWF_MM_ADD     _mm_add_epi32
+#define EWF_MM_MAX     _mm_max_epi32
+#define EWF_MM256_SET1 _mm256_set1_epi32
+#define EWF_MM256_ADD  _mm256_add_epi32
+#define EWF_MM256_MAX  _mm256_max_epi32
+#define EWF_MM512_SET1 _mm512_set1_epi32
+#define EWF_MM512_ADD  _mm512_add_epi32
+#define EWF_MM512_MAX  _mm512_max_epi32
+#else
+#define EDIT_WF_LANES_128 8
+#define EDIT_WF_LANES_256 16
+#define EDIT_WF_LANES_512 32
+#define EWF_MM_SET1    _mm_set1_epi16
+#define EWF_MM_ADD     _mm_add_epi16
+#define EWF_MM_MAX     _mm_max_epi16
+#define EWF_MM256_SET1 _mm256_set1_epi16
+#define EWF_MM256_ADD  _mm256_add_epi16
+#define EWF_MM256_MAX  _mm256_max_epi16
+#define EWF_MM512_SET1 _mm512_set1_epi16
+#define EWF_MM512_ADD  _mm512_add_epi16
+#define EWF_MM512_MAX  _mm512_max_epi16
+#endif
+
+/*
+ * Scalar kernel
+ */
+void edit_wavefront_compute_kernel_scalar(
+    const ewf_offset_t* const offsets,
+    ewf_offset_t* const next_offsets,
+    const int k_begin,
+    const int k_end) {
+  int k;
+  for (k=k_begin;k<=k_end;++k) {
+    /*
+     * const int del = offsets[k+1]; // Upper
+     * const int sub = offsets[k] + 1; // Mid
+     * const int ins = offsets[k-1] + 1; // Lower
+     * next_offsets[k] = MAX(sub,ins,del); // MAX
+     */
+    const ewf_offset_t max_ins_sub = MAX(offsets[k],offsets[k-1]) + 1;
+    next_offsets[k] = MAX(max_ins_sub,offsets[k+1]);
+  }
+}
+#ifdef EDIT_WF_COMPUTE_X86
+/*
+ * SSE4.1 kernel (8 diagonals per step; 4 with int32 offsets)
+ */
+__attribute__((target("sse4.1")))
+void edit_wavefront_compute_kernel_sse41(
+    const ewf_offset_t* const offsets,
+    ewf_offset_t* const next_offsets,
+    const int k_begin,
+    const int k_end) {
+  const __m128i ones = EWF_MM_SET1(1);
+  int k;
+  for (k=k_begin;k<=k_end;k+=EDIT_WF_LANES_128) {
+    const __m128i ins = _mm_loadu_si128((const __m128i*)(offsets+k-1));
+    const __m128i sub = _mm_loadu_si128((const __m128i*)(offsets+k));
+    const __m128i del = _mm_loadu_si128((const __m128i*)(offsets+k+1));
+    const __m128i max_ins_sub = EWF_MM_ADD(EWF_MM_MAX(ins,sub),ones);
+    _mm_storeu_si128((__m128i*)(next_offsets+k),EWF_MM_MAX(max_ins_sub,del));
+  }
+}
+/*
+ * AVX2 kernel (16 diagonals per step; 8 with int32 offsets)
+ */
+__attribute__((target("avx2")))
+void edit_wavefront_compute_kernel_avx2(
+    const ewf_offset_t* const offsets,
+    ewf_offset_t* const next_offsets,
+    const int k_begin,
+    const int k_end) {
+  const __m256i ones = EWF_MM256_SET1(1);
+  int k;
+  for (k=k_begin;k<=k_end;k+=EDIT_WF_LANES_256) {
+    const __m256i ins = _mm256_loadu_si256((const __m256i*)(offsets+k-1));
+    const __m256i sub = _mm256_loadu_si256((const __m256i*)(offsets+k));
+    const __m256i del = _mm256_loadu_si256((const __m256i*)(offsets+k+1));
+    const __m256i max_ins_sub = EWF_MM256_ADD(EWF_MM256_MAX(ins,sub),ones);
+    _mm256_storeu_si256((__m256i*)(next_offsets+k),EWF_MM256_MAX(max_ins_sub,del));
+  }
+}
+/*
+ * AVX-512 kernel (32 diagonals per step; 16 with int32 offsets)
+ */
+__attribute__((target("avx512bw")))
+void edit_wavefront_compute_kernel_avx512(
+    const ewf_offset_t* const offsets,
+    ewf_offset_t* const next_offsets,
+    const int k_begin,
+    const int k_end) {
+  const __m512i ones = EWF_MM512_SET1(1);
+  int k;
+  for (k=k_begin;k<=k_end;k+=EDIT_WF_LANES_512) {
+    const __m512i ins = _mm512_loadu_si512((const void*)(offsets+k-1));
+    const __m512i sub = _mm512_loadu_si512((const void*)(offsets+k));
+    const __m512i del = _mm512_loadu_si512((const void*)(offsets+k+1));
+    const __m512i max_ins_sub = EWF_MM512_ADD(EWF_MM512_MAX(ins,sub),ones);
+    _mm512_storeu_si512((void*)(next_offsets+k),EWF_MM512_MAX(max_ins_sub,del));
+  }
+}
+#endif
+/*
+ * Dispatch
+ */
+edit_wavefront_compute_kernel_f edit_wavefront_compute_kernel = NULL;
+edit_wavefront_compute_kernel_f edit_wavefront_compute_kernel_get(void) {
+  edit_wavefront_compute_kernel_f const selected_kernel =
+      __atomic_load_n(&edit_wavefront_compute_kernel,__ATOMIC_ACQUIRE);
+  if (selected_kernel != NULL) return selected_kernel;
+  // Select kernel (once; threads racing select the same one)
+  edit_wavefront_compute_kernel_f kernel = edit_wavefront_compute_kernel_scalar;
+#ifdef EDIT_WF_COMPUTE_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512bw")) {
+    kernel = edit_wavefront_compute_kernel_avx512;
+  } else if (__builtin_cpu_supports("avx2")) {
+    kernel = edit_wavefront_compute_kernel_avx2;
+  } else if (__builtin_cpu_supports("sse4.1")) {
+    kernel = edit_wavefront_compute_kernel_sse41;
+  }
+#endif
+  __atomic_store_n(&edit_wavefront_compute_kernel,kernel,__ATOMIC_RELEASE);
+  return kernel;
+}
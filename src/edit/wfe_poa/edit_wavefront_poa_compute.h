@@ -0,0 +1,59 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignments Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignments Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ */
+
+#ifndef EDIT_WAVEFRONT_COMPUTE_H_
+#define EDIT_WAVEFRONT_COMPUTE_H_
+
+#include "edit_wavefront_poa.h"
+
+/*
+ * Compute kernel
+ *   next_offsets[k] = MAX(offsets[k]+1,offsets[k-1]+1,offsets[k+1]) for k in [k_begin,k_end]
+ *   Reads offsets[k_begin-1,k_end+1] and may read/write up to EWAVEFRONT_PADDING
+ *   diagonals past k_end (see edit_wavefront_new)
+ */
+typedef void (*edit_wavefront_compute_kernel_f)(
+    const ewf_offset_t* const offsets,
+    ewf_offset_t* const next_offsets,
+    const int k_begin,
+    const int k_end);
+
+void edit_wavefront_compute_kernel_scalar(
+    const ewf_offset_t* const offsets,
+    ewf_offset_t* const next_offsets,
+    const int k_begin,
+    const int k_end);
+
+/*
+ * Dispatch (best kernel supported by the CPU, selected on first use)
+ */
+edit_wavefront_compute_kernel_f edit_wavefront_compute_kernel_get(void);
+
+#endif /* EDIT_WAVEFRONT_COMPUTE_H_ */
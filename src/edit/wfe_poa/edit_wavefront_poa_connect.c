@@ -45,8 +45,8 @@ void edit_wavefront_poa_connect_offset(
   char* const pattern = wavefront_segment->pattern;
   const int pattern_length = wavefront_segment->pattern_length;
   // Check next-connecting segments and open wavefronts
-  //   Note that next-segments should be posterior in the partial-ordered graph
-  //   Therefore, if connected, the next-segment will be extended on following iterations of this loop
+  //   Note that next-segments are posterior in the partial-ordered graph (higher rank)
+  //   Therefore, if connected, the next-segment will be extended later on within the same distance
   int i, j;
   for (i=0;i<text_segment->next_total;++i) {
     // Fetch next text-segment
@@ -55,25 +55,33 @@ void edit_wavefront_poa_connect_offset(
     // Fetch next wavefront-segment
     if (wavefront_poa->wavefront_segments[next_idx] == NULL) {
       wavefront_poa->wavefront_segments[next_idx] = edit_wavefront_segment_new(
-          pattern,pattern_length,next_text_segment,wavefront_poa->mm_allocator);
+          pattern,pattern_length,next_text_segment,wavefront_poa->mm_allocator_wavefronts);
       wavefront_poa->wavefront_segments[next_idx]->index = next_idx;
-      wavefront_poa->wavefront_segments[next_idx]->wf_distance_min = distance;
     }
     edit_wavefront_segment_t* const next_wavefront_segment = wavefront_poa->wavefront_segments[next_idx];
     const int next_h = 0; // Changes on g2g
     const int next_v = EWAVEFRONT_V(k,(int)offset);
     const int next_k = EWAVEFRONT_DIAGONAL(next_h,next_v);
     const int next_offset = 0; // Changes on g2g
+    // Check diagonal already exited the next-segment (dominated)
+    if (EDIT_WF_SEGMENT_DISABLED(next_wavefront_segment,next_k)) continue;
+    // Check diagonal already connected at a lower distance (same offset, dominated)
+    edit_wavefront_control_t* const next_control =
+        edit_wavefront_segment_get_control(next_wavefront_segment,next_k);
+    if (next_control != NULL && next_control->connected &&
+        next_control->current_wf_begin.distance < distance) continue;
     // Fetch wavefront
     bool wf_new = false;
-    if (next_wavefront_segment->wavefronts[distance] == NULL) {
-      next_wavefront_segment->wavefronts[distance] = edit_wavefront_new(
-          -pattern_length,next_text_segment->sequence_length,
-          next_k,next_k,wavefront_poa->mm_allocator);
-      next_wavefront_segment->wf_distance_max = distance;
+    edit_wavefront_t* next_wavefront =
+        edit_wavefront_segment_get_wavefront(next_wavefront_segment,distance);
+    if (next_wavefront == NULL) {
+      next_wavefront = edit_wavefront_segment_new_wavefront(next_wavefront_segment,next_k,next_k);
+      edit_wavefront_segment_set_wavefront(next_wavefront_segment,distance,next_wavefront);
       wf_new = true;
+    } else {
+      edit_wavefront_segment_reserve_wavefront(next_wavefront_segment,next_wavefront,next_k);
     }
-    edit_wavefront_t* const next_wavefront = next_wavefront_segment->wavefronts[distance];
+    edit_wavefront_poa_active_push(wavefront_poa,next_wavefront_segment,distance);
     // Check current offset
     bool set_offset = false;
     if (!wf_new && next_wavefront->lo <= next_k && next_k <= next_wavefront->hi) {
@@ -89,19 +97,28 @@ void edit_wavefront_poa_connect_offset(
       next_wavefront->offsets[next_k] = next_offset; // Same k on next-segment
       ++(next_wavefront_segment->num_valid_offsets);
       // Set previous-segment end location
-      edit_wavefront_locator_t* const previous_wf_end =
-          &next_wavefront_segment->control[next_k].previous_wf_end;
+      edit_wavefront_control_t* const control =
+          edit_wavefront_segment_add_control(next_wavefront_segment,next_k);
+      edit_wavefront_locator_t* const previous_wf_end = &control->previous_wf_end;
       previous_wf_end->segment_idx = wavefront_segment->index;
       previous_wf_end->distance = distance; // TODO Remove
       previous_wf_end->k = k;
       previous_wf_end->offset = offset;
       // Set current-segment begin location
-      edit_wavefront_locator_t* const current_wf_begin =
-          &next_wavefront_segment->control[next_k].current_wf_begin;
+      edit_wavefront_locator_t* const current_wf_begin = &control->current_wf_begin;
       current_wf_begin->segment_idx = next_idx;
       current_wf_begin->distance = distance; // TODO Remove
       current_wf_begin->k = next_k;
       current_wf_begin->offset = next_offset;
+      control->connected = true;
+      // Keep connected offset to recompute from checkpoints
+      if (wavefront_poa->memory_mode == edit_wavefront_poa_memory_checkpoint) {
+        if (next_wavefront_segment->injections == NULL) {
+          next_wavefront_segment->injections = edit_wavefront_poa_injections_new(wavefront_poa);
+        }
+        edit_wavefront_injection_t injection = { .distance = distance, .k = next_k };
+        vector_insert(next_wavefront_segment->injections,injection,edit_wavefront_injection_t);
+      }
     }
     // Fill gap in the wavefront (if any)
     if (next_k > next_wavefront->hi) {
@@ -53,11 +53,12 @@ void edit_wavefront_poa_print_wavefront_segment(
   const int min_k = -(wavefront_segment->pattern_length - 1);
   // Traverse all diagonals
   for (k=max_k;k>=min_k;k--) {
-    fprintf(stream,"[%s]", (wavefront_segment->control[k]).disabled ? "  ":"ON");
+    fprintf(stream,"[%s]", EDIT_WF_SEGMENT_DISABLED(wavefront_segment,k) ? "  ":"ON");
     fprintf(stream,"[k=%3d] ",k);
     // Traverse all scores
     for (s=min_distance;s<=max_distance;++s) {
-      edit_wavefront_t* const wavefront = wavefront_segment->wavefronts[s];
+      edit_wavefront_t* const wavefront =
+          edit_wavefront_segment_get_wavefront(wavefront_segment,s);
       if (wavefront == NULL) {
         fprintf(stream,"      ");
       } else {
@@ -31,41 +31,123 @@
 #include "edit_wavefront_poa_extend.h"
 #include "edit_wavefront_poa_connect.h"
 
+/*
+ * Count exact-matches
+ */
+int edit_wavefront_poa_extend_matches(
+    const char* const pattern,
+    const int v,
+    const int pattern_length,
+    const char* const text,
+    const int h,
+    const int text_length) {
+  // Bound to the end of the segment/pattern (sentinels are never compared)
+  const int max_matches = MIN(pattern_length-v,text_length-h);
+  int num_matches = 0;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  // Compare blocks of 8 characters (first mismatching byte from the lowest set bit)
+  while (num_matches+8 <= max_matches) {
+    uint64_t pattern_block, text_block;
+    memcpy(&pattern_block,pattern+v+num_matches,8);
+    memcpy(&text_block,text+h+num_matches,8);
+    const uint64_t mismatches = pattern_block ^ text_block;
+    if (mismatches != 0) return num_matches + (__builtin_ctzll(mismatches) >> 3);
+    num_matches += 8;
+  }
+#endif
+  // Compare remaining characters
+  while (num_matches<max_matches && pattern[v+num_matches]==text[h+num_matches]) {
+    ++num_matches;
+  }
+  return num_matches;
+}
+uint64_t edit_wavefront_poa_extend_packed_block(
+    const uint64_t* const sequence_packed,
+    const int position) {
+  // Fetch the 32 bases from position (spanning two words if unaligned)
+  const int word = position >> 5;
+  const int shift = (position & 31) << 1;
+  if (shift == 0) return sequence_packed[word];
+  return (sequence_packed[word] >> shift) | (sequence_packed[word+1] << (64-shift));
+}
+int edit_wavefront_poa_extend_matches_packed(
+    const uint64_t* const pattern_packed,
+    const int v,
+    const int pattern_length,
+    const uint64_t* const text_packed,
+    const int h,
+    const int text_length) {
+  // Bound to the end of the segment/pattern (sentinels are not packed)
+  const int max_matches = MIN(pattern_length-v,text_length-h);
+  int num_matches = 0;
+  // Compare blocks of 32 bases (first mismatching base from the lowest set bit)
+  while (num_matches < max_matches) {
+    uint64_t mismatches =
+        edit_wavefront_poa_extend_packed_block(pattern_packed,v+num_matches) ^
+        edit_wavefront_poa_extend_packed_block(text_packed,h+num_matches);
+    const int bases_left = max_matches - num_matches;
+    if (bases_left < 32) mismatches &= (1ull << (bases_left << 1)) - 1; // Last block
+    if (mismatches != 0) return num_matches + (__builtin_ctzll(mismatches) >> 1);
+    num_matches += 32;
+  }
+  return max_matches;
+}
 /*
  * Extend exact-matches of Wavefront-Segment
  */
-bool edit_wavefront_poa_segment_extend(
+bool edit_wavefront_poa_segment_extend_range(
     edit_wavefront_poa_t* const wavefront_poa,
     edit_wavefront_segment_t* const wavefront_segment,
     text_dag_t* const text_dag,
     const int distance,
-    edit_wavefront_locator_t* const wf_alignment) {
+    const int k_begin,
+    const int k_end,
+    edit_wavefront_locator_t* const wf_alignment,
+    vector_t* const exits,
+    int* const num_valid_offsets_range) {
   // Parameters
   text_dag_segment_t* const text_segment = wavefront_segment->text_segment;
   const char* const pattern = wavefront_segment->pattern;
   const int pattern_length = wavefront_segment->pattern_length;
   const char* const text = text_segment->sequence;
   const int text_length = text_segment->sequence_length;
+  const uint64_t* const pattern_packed = wavefront_poa->pattern_packed;
+  const uint64_t* const text_packed = text_segment->sequence_packed;
+  const bool packed = (pattern_packed != NULL && text_packed != NULL);
   // Fetch wavefront
-  edit_wavefront_t* const wavefront = wavefront_segment->wavefronts[distance];
+  edit_wavefront_t* const wavefront =
+      edit_wavefront_segment_get_wavefront(wavefront_segment,distance);
   ewf_offset_t* const offsets = wavefront->offsets;
-  const int k_min = wavefront->lo;
-  const int k_max = wavefront->hi;
   // Extend diagonally each wavefront point
-  int k;
-  for (k=k_min;k<=k_max;++k) {
+  int k, num_valid_offsets = 0;
+  for (k=k_begin;k<=k_end;++k) {
     // Check diagonal disabled
-    if (wavefront_segment->control[k].disabled) {
+    if (EDIT_WF_SEGMENT_DISABLED(wavefront_segment,k)) {
       offsets[k] = EWAVEFRONT_OFFSET_NULL;
       continue;
     }
     // Locate offset and extend
     int v = EWAVEFRONT_V(k,offsets[k]);
     int h = EWAVEFRONT_H(k,offsets[k]);
-    while (v<pattern_length && h<text_length && pattern[v]==text[h]) {
-      ++(offsets[k]);
-      ++v;
-      ++h;
+    if (h < 0 || h > text_length || v < 0 || v > pattern_length) { // Null/out-of-bounds offset
+      offsets[k] = EWAVEFRONT_OFFSET_NULL;
+      continue;
+    }
+    const int num_matches = (packed) ?
+        edit_wavefront_poa_extend_matches_packed(
+            pattern_packed,v,pattern_length,text_packed,h,text_length) :
+        edit_wavefront_poa_extend_matches(
+            pattern,v,pattern_length,text,h,text_length);
+    offsets[k] += num_matches;
+    v += num_matches;
+    h += num_matches;
+    // Check end-of-pattern (ends-free, the rest of the text-DAG is left unaligned)
+    if (v == pattern_length && wavefront_poa->text_end_free) {
+      wf_alignment->k = k;
+      wf_alignment->offset = offsets[k];
+      wf_alignment->distance = distance;
+      wf_alignment->segment_idx = wavefront_segment->index;
+      return true; // End-of-Pattern
     }
     // Check for sentinel. Sentinel in text means:
     //   (1) Connect to next-segment
@@ -73,14 +155,22 @@ bool edit_wavefront_poa_segment_extend(
     if (text[h] == 'X') {
       // Check next-connecting segments
       if (text_segment->next_total == 0) { // End-of-Graph
-        // Check end-of-alignment
-        if (pattern[v] == 'Y') {
+        // Check end-of-alignment (ends-free, the pattern suffix is left unaligned)
+        if (v >= pattern_length - wavefront_poa->pattern_end_free) {
           wf_alignment->k = k;
           wf_alignment->offset = offsets[k];
           wf_alignment->distance = distance;
           wf_alignment->segment_idx = wavefront_segment->index;
           return true; // End-of-Pattern
         }
+        ++num_valid_offsets;
+        continue; // Keep offset (pattern left to delete at the end of the graph)
+      } else if (exits != NULL) {
+        // Defer connection (and disabling) to the caller
+        edit_wavefront_exit_t exit = { .k = k, .offset = offsets[k] };
+        vector_insert(exits,exit,edit_wavefront_exit_t);
+        offsets[k] = EWAVEFRONT_OFFSET_NULL;
+        continue;
       } else {
         // Connect with next-segments and open new wavefronts
         edit_wavefront_poa_connect_offset(wavefront_poa,
@@ -88,11 +178,34 @@ bool edit_wavefront_poa_segment_extend(
       }
       // Close offset in current segment
       offsets[k] = EWAVEFRONT_OFFSET_NULL; // FIXME: I don't really like this (nor I fully understand)
-      wavefront_segment->control[k].disabled = true;
-      --(wavefront_segment->num_valid_offsets);
+      edit_wavefront_segment_disable(wavefront_segment,k,distance);
+      continue;
     }
+    ++num_valid_offsets;
   }
+  // Return active offsets
+  *num_valid_offsets_range = num_valid_offsets;
   // No End-of-Alignment
   return false;
 }
+bool edit_wavefront_poa_segment_extend(
+    edit_wavefront_poa_t* const wavefront_poa,
+    edit_wavefront_segment_t* const wavefront_segment,
+    text_dag_t* const text_dag,
+    const int distance,
+    edit_wavefront_locator_t* const wf_alignment,
+    vector_t* const exits) {
+  // Fetch wavefront
+  edit_wavefront_t* const wavefront =
+      edit_wavefront_segment_get_wavefront(wavefront_segment,distance);
+  // Extend the whole wavefront
+  int num_valid_offsets;
+  const bool alignment_end = edit_wavefront_poa_segment_extend_range(
+      wavefront_poa,wavefront_segment,text_dag,distance,
+      wavefront->lo,wavefront->hi,wf_alignment,exits,&num_valid_offsets);
+  if (alignment_end) return true;
+  // Update active offsets
+  wavefront_segment->num_valid_offsets = num_valid_offsets;
+  return false;
+}
 
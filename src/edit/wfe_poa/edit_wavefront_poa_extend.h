@@ -33,14 +33,56 @@
 
 #include "edit_wavefront_poa.h"
 
+/*
+ * Count exact-matches from (v,h) (blockwise, 8 characters per step)
+ *   Never reads past pattern[pattern_length-1] or text[text_length-1]
+ */
+int edit_wavefront_poa_extend_matches(
+    const char* const pattern,
+    const int v,
+    const int pattern_length,
+    const char* const text,
+    const int h,
+    const int text_length);
+
+/*
+ * Count exact-matches from (v,h) over 2-bit packed sequences (32 bases per step)
+ *   Used when both the pattern and the text-segment are packed (see text_dag_pack)
+ */
+uint64_t edit_wavefront_poa_extend_packed_block(
+    const uint64_t* const sequence_packed,
+    const int position);
+int edit_wavefront_poa_extend_matches_packed(
+    const uint64_t* const pattern_packed,
+    const int v,
+    const int pattern_length,
+    const uint64_t* const text_packed,
+    const int h,
+    const int text_length);
+
 /*
  * Extend exact-matches of Wavefront-Segment
+ *   Diagonals reaching the end of the segment are connected into the next-segments,
+ *   unless exits is given (parallel extend). Then, they are closed and kept in exits
+ *   to be connected (and disabled) later on by the caller. The range variant extends
+ *   the diagonals [k_begin,k_end] and returns their active offsets (parallel chunks)
  */
+bool edit_wavefront_poa_segment_extend_range(
+    edit_wavefront_poa_t* const wavefront_poa,
+    edit_wavefront_segment_t* const wavefront_segment,
+    text_dag_t* const text_dag,
+    const int distance,
+    const int k_begin,
+    const int k_end,
+    edit_wavefront_locator_t* const wf_alignment,
+    vector_t* const exits,
+    int* const num_valid_offsets_range);
 bool edit_wavefront_poa_segment_extend(
     edit_wavefront_poa_t* const wavefront_poa,
     edit_wavefront_segment_t* const wavefront_segment,
     text_dag_t* const text_dag,
     const int distance,
-    edit_wavefront_locator_t* const wf_alignment);
+    edit_wavefront_locator_t* const wf_alignment,
+    vector_t* const exits);
 
 #endif /* EDIT_WAVEFRONT_EXTEND_H_ */
@@ -0,0 +1,127 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignments Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignments Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: Int32-offsets instance of the Edit Wavefront-POA engine (symbol renaming)
+ */
+
+#ifndef EDIT_WAVEFRONT_OFFSET32_H_
+#define EDIT_WAVEFRONT_OFFSET32_H_
+
+/*
+ * Int32-offsets instance
+ *   The engine sources are compiled twice (see Makefile). The default build uses
+ *   int16 offsets; the EWAVEFRONT_OFFSET_32 build renames every engine symbol with
+ *   the "_offset32" suffix so both instances link together.
+ */
+#define edit_wavefront_compute_kernel                    edit_wavefront_compute_kernel_offset32
+#define edit_wavefront_compute_kernel_avx2               edit_wavefront_compute_kernel_avx2_offset32
+#define edit_wavefront_compute_kernel_avx512             edit_wavefront_compute_kernel_avx512_offset32
+#define edit_wavefront_compute_kernel_get                edit_wavefront_compute_kernel_get_offset32
+#define edit_wavefront_compute_kernel_scalar             edit_wavefront_compute_kernel_scalar_offset32
+#define edit_wavefront_compute_kernel_sse41              edit_wavefront_compute_kernel_sse41_offset32
+#define edit_wavefront_delete                            edit_wavefront_delete_offset32
+#define edit_wavefront_new                               edit_wavefront_new_offset32
+#define edit_wavefront_poa_active_next_distance          edit_wavefront_poa_active_next_distance_offset32
+#define edit_wavefront_poa_active_pop                    edit_wavefront_poa_active_pop_offset32
+#define edit_wavefront_poa_active_push                   edit_wavefront_poa_active_push_offset32
+#define edit_wavefront_poa_active_push_next              edit_wavefront_poa_active_push_next_offset32
+#define edit_wavefront_poa_align                         edit_wavefront_poa_align_offset32
+#define edit_wavefront_poa_align_batch                   edit_wavefront_poa_align_batch_offset32
+#define edit_wavefront_poa_align_bidirectional           edit_wavefront_poa_align_bidirectional_offset32
+#define edit_wavefront_poa_align_compute_next            edit_wavefront_poa_align_compute_next_offset32
+#define edit_wavefront_poa_align_cutoff                  edit_wavefront_poa_align_cutoff_offset32
+#define edit_wavefront_poa_align_extend                  edit_wavefront_poa_align_extend_offset32
+#define edit_wavefront_poa_align_init                    edit_wavefront_poa_align_init_offset32
+#define edit_wavefront_poa_align_seed                    edit_wavefront_poa_align_seed_offset32
+#define edit_wavefront_poa_backtrace                     edit_wavefront_poa_backtrace_offset32
+#define edit_wavefront_poa_backtrace_begin               edit_wavefront_poa_backtrace_begin_offset32
+#define edit_wavefront_poa_backtrace_seeded              edit_wavefront_poa_backtrace_seeded_offset32
+#define edit_wavefront_poa_backtrace_segment             edit_wavefront_poa_backtrace_segment_offset32
+#define edit_wavefront_poa_batch_align_task              edit_wavefront_poa_batch_align_task_offset32
+#define edit_wavefront_poa_batch_delete                  edit_wavefront_poa_batch_delete_offset32
+#define edit_wavefront_poa_batch_new                     edit_wavefront_poa_batch_new_offset32
+#define edit_wavefront_poa_bidirectional_align_range     edit_wavefront_poa_bidirectional_align_range_offset32
+#define edit_wavefront_poa_bidirectional_breakpoint      edit_wavefront_poa_bidirectional_breakpoint_offset32
+#define edit_wavefront_poa_bidirectional_overlap         edit_wavefront_poa_bidirectional_overlap_offset32
+#define edit_wavefront_poa_bidirectional_prepend         edit_wavefront_poa_bidirectional_prepend_offset32
+#define edit_wavefront_poa_bidirectional_range           edit_wavefront_poa_bidirectional_range_offset32
+#define edit_wavefront_poa_bidirectional_reach           edit_wavefront_poa_bidirectional_reach_offset32
+#define edit_wavefront_poa_checkpoint_extend             edit_wavefront_poa_checkpoint_extend_offset32
+#define edit_wavefront_poa_checkpoint_get_wavefront      edit_wavefront_poa_checkpoint_get_wavefront_offset32
+#define edit_wavefront_poa_checkpoint_inject             edit_wavefront_poa_checkpoint_inject_offset32
+#define edit_wavefront_poa_checkpoint_recompute          edit_wavefront_poa_checkpoint_recompute_offset32
+#define edit_wavefront_poa_clear                         edit_wavefront_poa_clear_offset32
+#define edit_wavefront_poa_connect_offset                edit_wavefront_poa_connect_offset_offset32
+#define edit_wavefront_poa_delete                        edit_wavefront_poa_delete_offset32
+#define edit_wavefront_poa_extend_matches                edit_wavefront_poa_extend_matches_offset32
+#define edit_wavefront_poa_extend_matches_packed         edit_wavefront_poa_extend_matches_packed_offset32
+#define edit_wavefront_poa_extend_packed_block           edit_wavefront_poa_extend_packed_block_offset32
+#define edit_wavefront_poa_injections_new                edit_wavefront_poa_injections_new_offset32
+#define edit_wavefront_poa_new                           edit_wavefront_poa_new_offset32
+#define edit_wavefront_poa_offsets16_fit                 edit_wavefront_poa_offsets16_fit_offset32
+#define edit_wavefront_poa_parallel_add_chunks           edit_wavefront_poa_parallel_add_chunks_offset32
+#define edit_wavefront_poa_parallel_compute_next         edit_wavefront_poa_parallel_compute_next_offset32
+#define edit_wavefront_poa_parallel_compute_next_task    edit_wavefront_poa_parallel_compute_next_task_offset32
+#define edit_wavefront_poa_parallel_extend               edit_wavefront_poa_parallel_extend_offset32
+#define edit_wavefront_poa_parallel_extend_task          edit_wavefront_poa_parallel_extend_task_offset32
+#define edit_wavefront_poa_parallel_task                 edit_wavefront_poa_parallel_task_offset32
+#define edit_wavefront_poa_print                         edit_wavefront_poa_print_offset32
+#define edit_wavefront_poa_print_wavefront_segment       edit_wavefront_poa_print_wavefront_segment_offset32
+#define edit_wavefront_poa_reduce                        edit_wavefront_poa_reduce_offset32
+#define edit_wavefront_poa_reduction_estimate            edit_wavefront_poa_reduction_estimate_offset32
+#define edit_wavefront_poa_reduction_get_bound           edit_wavefront_poa_reduction_get_bound_offset32
+#define edit_wavefront_poa_reduction_init                edit_wavefront_poa_reduction_init_offset32
+#define edit_wavefront_poa_resize                        edit_wavefront_poa_resize_offset32
+#define edit_wavefront_poa_segment_extend                edit_wavefront_poa_segment_extend_offset32
+#define edit_wavefront_poa_segment_extend_range          edit_wavefront_poa_segment_extend_range_offset32
+#define edit_wavefront_poa_set_cutoff                    edit_wavefront_poa_set_cutoff_offset32
+#define edit_wavefront_poa_set_ends_free                 edit_wavefront_poa_set_ends_free_offset32
+#define edit_wavefront_poa_set_memory_mode               edit_wavefront_poa_set_memory_mode_offset32
+#define edit_wavefront_poa_set_parallel_wavefront_length edit_wavefront_poa_set_parallel_wavefront_length_offset32
+#define edit_wavefront_poa_set_reduction                 edit_wavefront_poa_set_reduction_offset32
+#define edit_wavefront_poa_set_threads                   edit_wavefront_poa_set_threads_offset32
+#define edit_wavefront_poa_tasks_free                    edit_wavefront_poa_tasks_free_offset32
+#define edit_wavefront_segment_add_control               edit_wavefront_segment_add_control_offset32
+#define edit_wavefront_segment_compute_next              edit_wavefront_segment_compute_next_offset32
+#define edit_wavefront_segment_compute_next_allocate     edit_wavefront_segment_compute_next_allocate_offset32
+#define edit_wavefront_segment_compute_next_offsets      edit_wavefront_segment_compute_next_offsets_offset32
+#define edit_wavefront_segment_controls_resize           edit_wavefront_segment_controls_resize_offset32
+#define edit_wavefront_segment_delete                    edit_wavefront_segment_delete_offset32
+#define edit_wavefront_segment_disable                   edit_wavefront_segment_disable_offset32
+#define edit_wavefront_segment_free_wavefront            edit_wavefront_segment_free_wavefront_offset32
+#define edit_wavefront_segment_get_control               edit_wavefront_segment_get_control_offset32
+#define edit_wavefront_segment_get_wavefront             edit_wavefront_segment_get_wavefront_offset32
+#define edit_wavefront_segment_is_active                 edit_wavefront_segment_is_active_offset32
+#define edit_wavefront_segment_new                       edit_wavefront_segment_new_offset32
+#define edit_wavefront_segment_new_wavefront             edit_wavefront_segment_new_wavefront_offset32
+#define edit_wavefront_segment_reduce                    edit_wavefront_segment_reduce_offset32
+#define edit_wavefront_segment_release                   edit_wavefront_segment_release_offset32
+#define edit_wavefront_segment_reserve_wavefront         edit_wavefront_segment_reserve_wavefront_offset32
+#define edit_wavefront_segment_set_wavefront             edit_wavefront_segment_set_wavefront_offset32
+
+#endif /* EDIT_WAVEFRONT_OFFSET32_H_ */
@@ -0,0 +1,235 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of WFPOA.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Partial Order Alignment Wavefront Alignment (WFPOA)
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: Parallel Edit Wavefront-POA (segment-parallel and intra-wavefront)
+ */
+
+#include "edit_wavefront_poa_parallel.h"
+#include "edit_wavefront_poa_align.h"
+#include "edit_wavefront_poa_connect.h"
+#include "edit_wavefront_poa_extend.h"
+
+/*
+ * Parallel task arguments
+ */
+typedef struct {
+  edit_wavefront_poa_t* wavefront_poa;
+  text_dag_t* text_dag;
+  int distance;
+} edit_wavefront_parallel_args_t;
+
+/*
+ * Parallel chunks
+ */
+edit_wavefront_task_t* edit_wavefront_poa_parallel_task(
+    edit_wavefront_poa_t* const wavefront_poa,
+    const int task_idx) {
+  // Grow tasks
+  if (task_idx >= wavefront_poa->tasks_allocated) {
+    const int tasks_allocated = MAX(2*wavefront_poa->tasks_allocated,task_idx+16);
+    edit_wavefront_task_t* const tasks = mm_allocator_calloc(
+        wavefront_poa->mm_allocator,tasks_allocated,edit_wavefront_task_t,true);
+    if (wavefront_poa->tasks != NULL) {
+      memcpy(tasks,wavefront_poa->tasks,wavefront_poa->tasks_allocated*sizeof(edit_wavefront_task_t));
+      mm_allocator_free(wavefront_poa->mm_allocator,wavefront_poa->tasks);
+    }
+    wavefront_poa->tasks = tasks;
+    wavefront_poa->tasks_allocated = tasks_allocated;
+  }
+  // Return task
+  return wavefront_poa->tasks + task_idx;
+}
+int edit_wavefront_poa_parallel_add_chunks(
+    edit_wavefront_poa_t* const wavefront_poa,
+    const int num_tasks,
+    const int segment_idx,
+    const int k_begin,
+    const int k_end) {
+  // Compute chunk length
+  const int length = k_end - k_begin + 1;
+  int chunk_length = length;
+  if (length >= wavefront_poa->parallel_wavefront_length) {
+    const int num_chunks = wavefront_poa->num_threads*EWAVEFRONT_PARALLEL_CHUNKS_PER_THREAD;
+    chunk_length = DIV_CEIL(length,num_chunks);
+    chunk_length = DIV_CEIL(chunk_length,EWAVEFRONT_PARALLEL_CHUNK_ALIGN)*EWAVEFRONT_PARALLEL_CHUNK_ALIGN;
+  }
+  // Add chunks
+  int task_idx = num_tasks, k = k_begin;
+  do {
+    edit_wavefront_task_t* const task = edit_wavefront_poa_parallel_task(wavefront_poa,task_idx++);
+    task->segment_idx = segment_idx;
+    task->k_begin = k;
+    task->k_end = MIN(k+chunk_length-1,k_end);
+    k += chunk_length;
+  } while (k <= k_end);
+  return task_idx;
+}
+/*
+ * Parallel extend
+ */
+void edit_wavefront_poa_parallel_extend_task(
+    void* const args,
+    const int task_idx,
+    const int thread_idx) {
+  // Parameters
+  edit_wavefront_parallel_args_t* const parallel_args = (edit_wavefront_parallel_args_t*)args;
+  edit_wavefront_poa_t* const wavefront_poa = parallel_args->wavefront_poa;
+  edit_wavefront_task_t* const task = wavefront_poa->tasks + task_idx;
+  // Extend chunk (deferring exits)
+  task->alignment_end = edit_wavefront_poa_segment_extend_range(
+      wavefront_poa,wavefront_poa->wavefront_segments[task->segment_idx],
+      parallel_args->text_dag,parallel_args->distance,task->k_begin,task->k_end,
+      &task->wf_alignment,task->exits,&task->num_valid_offsets);
+}
+bool edit_wavefront_poa_parallel_extend(
+    edit_wavefront_poa_t* const wavefront_poa,
+    text_dag_t* const text_dag,
+    const int distance,
+    edit_wavefront_locator_t* const wf_alignment) {
+  // Parameters
+  edit_wavefront_segment_t** const wavefront_segments = wavefront_poa->wavefront_segments;
+  const int* const rank = wavefront_poa->segment_id_to_rank;
+  edit_wavefront_parallel_args_t parallel_args = {
+      .wavefront_poa = wavefront_poa,
+      .text_dag = text_dag,
+      .distance = distance,
+  };
+  int i, j, e;
+  // Extend active segments (in batches)
+  while (wavefront_poa->num_active_segments > 0) {
+    // Gather batch (segments ranked below any next-segment of the batch)
+    int num_tasks = 0, next_rank_min = INT_MAX;
+    while (wavefront_poa->num_active_segments > 0 &&
+           rank[wavefront_poa->active_segments[0]] < next_rank_min) {
+      const int segment_idx = edit_wavefront_poa_active_pop(wavefront_poa);
+      edit_wavefront_segment_t* const wavefront_segment = wavefront_segments[segment_idx];
+      if (!edit_wavefront_segment_is_active(wavefront_segment,distance)) continue; // Check active
+      edit_wavefront_t* const wavefront = edit_wavefront_segment_get_wavefront(wavefront_segment,distance);
+      num_tasks = edit_wavefront_poa_parallel_add_chunks(
+          wavefront_poa,num_tasks,segment_idx,wavefront->lo,wavefront->hi);
+      text_dag_segment_t* const text_segment = wavefront_segment->text_segment;
+      for (j=0;j<text_segment->next_total;++j) {
+        next_rank_min = MIN(next_rank_min,rank[text_segment->next[j]]);
+      }
+    }
+    edit_wavefront_task_t* const tasks = wavefront_poa->tasks;
+    for (i=0;i<num_tasks;++i) {
+      if (tasks[i].exits == NULL) tasks[i].exits = vector_new(16,edit_wavefront_exit_t);
+      vector_clear(tasks[i].exits);
+    }
+    // Extend batch
+    thread_pool_run(wavefront_poa->thread_pool,
+        edit_wavefront_poa_parallel_extend_task,&parallel_args,num_tasks);
+    // Merge chunks (in rank and diagonal order)
+    for (i=0;i<num_tasks;i=j) {
+      edit_wavefront_segment_t* const wavefront_segment = wavefront_segments[tasks[i].segment_idx];
+      int num_valid_offsets = 0;
+      for (j=i;j<num_tasks && tasks[j].segment_idx==tasks[i].segment_idx;++j) {
+        edit_wavefront_task_t* const task = tasks + j;
+        // Check exit condition
+        if (task->alignment_end) {
+          *wf_alignment = task->wf_alignment;
+          wavefront_poa->alignment_distance = distance;
+          return true;
+        }
+        num_valid_offsets += task->num_valid_offsets;
+        // Connect with next-segments and close diagonals
+        const int num_exits = vector_get_used(task->exits);
+        edit_wavefront_exit_t* const exits = vector_get_mem(task->exits,edit_wavefront_exit_t);
+        for (e=0;e<num_exits;++e) {
+          edit_wavefront_poa_connect_offset(wavefront_poa,
+              wavefront_segment,text_dag,distance,exits[e].k,exits[e].offset);
+          edit_wavefront_segment_disable(wavefront_segment,exits[e].k,distance);
+        }
+      }
+      // Update active offsets
+      wavefront_segment->num_valid_offsets = num_valid_offsets;
+      // Keep extended segment (candidate for the next distance)
+      edit_wavefront_poa_active_push_next(wavefront_poa,wavefront_segment,distance+1);
+    }
+  }
+  // No End-of-Alignment
+  return false;
+}
+/*
+ * Parallel compute-next
+ */
+void edit_wavefront_poa_parallel_compute_next_task(
+    void* const args,
+    const int task_idx,
+    const int thread_idx) {
+  // Parameters
+  edit_wavefront_parallel_args_t* const parallel_args = (edit_wavefront_parallel_args_t*)args;
+  edit_wavefront_poa_t* const wavefront_poa = parallel_args->wavefront_poa;
+  edit_wavefront_task_t* const task = wavefront_poa->tasks + task_idx;
+  // Compute next wavefront offsets (chunk)
+  edit_wavefront_segment_compute_next_offsets(
+      wavefront_poa->wavefront_segments[task->segment_idx],
+      parallel_args->distance,task->k_begin,task->k_end);
+}
+void edit_wavefront_poa_parallel_compute_next(
+    edit_wavefront_poa_t* const wavefront_poa,
+    const int distance) {
+  // Parameters
+  edit_wavefront_segment_t** const wavefront_segments = wavefront_poa->wavefront_segments;
+  int* const next_active_segments = wavefront_poa->next_active_segments;
+  const int num_extended_segments = wavefront_poa->num_next_active_segments;
+  edit_wavefront_parallel_args_t parallel_args = {
+      .wavefront_poa = wavefront_poa,
+      .text_dag = NULL,
+      .distance = distance+1,
+  };
+  int i, num_tasks = 0;
+  // Allocate next wavefronts
+  for (i=0;i<num_extended_segments;++i) {
+    const int segment_idx = next_active_segments[i];
+    edit_wavefront_segment_t* const wavefront_segment = wavefront_segments[segment_idx];
+    if (edit_wavefront_segment_compute_next_allocate(wavefront_segment,distance+1) == NULL) continue;
+    edit_wavefront_t* const wavefront = edit_wavefront_segment_get_wavefront(wavefront_segment,distance);
+    num_tasks = edit_wavefront_poa_parallel_add_chunks(
+        wavefront_poa,num_tasks,segment_idx,wavefront->lo-1,wavefront->hi+1);
+  }
+  // Compute next wavefronts
+  thread_pool_run(wavefront_poa->thread_pool,
+      edit_wavefront_poa_parallel_compute_next_task,&parallel_args,num_tasks);
+  // Drop inactive segments and release wavefronts
+  int num_next_active_segments = 0;
+  for (i=0;i<num_extended_segments;++i) {
+    const int segment_idx = next_active_segments[i];
+    edit_wavefront_segment_t* const wavefront_segment = wavefront_segments[segment_idx];
+    if (wavefront_segment->num_valid_offsets > 0) {
+      next_active_segments[num_next_active_segments++] = segment_idx;
+    } else {
+      wavefront_segment->active_distance = -1;
+    }
+    edit_wavefront_segment_release(wavefront_poa,wavefront_segment,distance);
+  }
+  wavefront_poa->num_next_active_segments = num_next_active_segments;
+  // Next distance
+  edit_wavefront_poa_active_next_distance(wavefront_poa);
+}
@@ -0,0 +1,85 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignments Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignments Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: Parallel Edit Wavefront-POA (segment-parallel and intra-wavefront)
+ */
+
+#ifndef EDIT_WAVEFRONT_PARALLEL_H_
+#define EDIT_WAVEFRONT_PARALLEL_H_
+
+#include "edit_wavefront_poa.h"
+
+/*
+ * Parallel chunks
+ *   Each task extends/computes a chunk of diagonals of one segment. Wavefronts shorter
+ *   than the parallel-wavefront-length are a single chunk. Longer ones are split
+ *   in about EWAVEFRONT_PARALLEL_CHUNKS_PER_THREAD chunks per thread, each a multiple
+ *   of the vector kernel lanes (so no kernel writes past the end of its chunk)
+ */
+#define EWAVEFRONT_PARALLEL_CHUNKS_PER_THREAD 4
+#define EWAVEFRONT_PARALLEL_CHUNK_ALIGN      32
+
+int edit_wavefront_poa_parallel_add_chunks(
+    edit_wavefront_poa_t* const wavefront_poa,
+    const int num_tasks,
+    const int segment_idx,
+    const int k_begin,
+    const int k_end);
+
+/*
+ * Parallel extend
+ *   Active segments are extended in batches of consecutive ranks below the lowest
+ *   rank of their next-segments. As offsets are only connected forward (higher rank),
+ *   no segment in the batch can receive offsets from another one within the same
+ *   distance. Thus, the chunks of the batch are extended in parallel and the exits
+ *   are connected afterwards (in rank and diagonal order, as the sequential extend does)
+ */
+void edit_wavefront_poa_parallel_extend_task(
+    void* const args,
+    const int task_idx,
+    const int thread_idx);
+bool edit_wavefront_poa_parallel_extend(
+    edit_wavefront_poa_t* const wavefront_poa,
+    text_dag_t* const text_dag,
+    const int distance,
+    edit_wavefront_locator_t* const wf_alignment);
+
+/*
+ * Parallel compute-next
+ *   Next wavefronts are allocated beforehand (the MM-allocator is not thread-safe)
+ *   and the chunks of their offsets computed in parallel
+ */
+void edit_wavefront_poa_parallel_compute_next_task(
+    void* const args,
+    const int task_idx,
+    const int thread_idx);
+void edit_wavefront_poa_parallel_compute_next(
+    edit_wavefront_poa_t* const wavefront_poa,
+    const int distance);
+
+#endif /* EDIT_WAVEFRONT_PARALLEL_H_ */
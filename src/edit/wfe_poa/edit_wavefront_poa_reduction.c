@@ -0,0 +1,152 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of WFPOA.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Partial Order Alignment Wavefront Alignment (WFPOA)
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ */
+
+#include "edit_wavefront_poa_reduction.h"
+
+/*
+ * Setup
+ */
+void edit_wavefront_poa_reduction_init(
+    edit_wavefront_poa_t* const wavefront_poa,
+    text_dag_t* const text_dag) {
+  // Parameters
+  int* const text_left = wavefront_poa->reduction_text_left;
+  const int segments_total = text_dag->segments_total;
+  // Shortest text left to the sink (in reverse topological order)
+  int rank, i;
+  for (rank=segments_total-1;rank>=0;--rank) {
+    const int segment_idx = text_dag->rank_to_segment_id[rank];
+    text_dag_segment_t* const segment = text_dag->segments_ts[segment_idx];
+    int min_left = (segment->next_total == 0) ? 0 : INT_MAX;
+    for (i=0;i<segment->next_total;++i) {
+      const int next_idx = segment->next[i];
+      if (text_left[next_idx] == INT_MAX) continue; // Sink not reachable
+      const int next_left = text_dag->segments_ts[next_idx]->sequence_length + text_left[next_idx];
+      min_left = MIN(min_left,next_left);
+    }
+    text_left[segment_idx] = min_left;
+  }
+  // Clear bounds
+  vector_clear(wavefront_poa->reduction_bounds);
+}
+/*
+ * Estimated distance to the end of the alignment
+ */
+int edit_wavefront_poa_reduction_estimate(
+    edit_wavefront_poa_t* const wavefront_poa,
+    edit_wavefront_segment_t* const wavefront_segment,
+    const int k,
+    const int offset) {
+  // Parameters
+  const int pattern_left = MAX(wavefront_segment->pattern_length -
+      EWAVEFRONT_V(k,offset) - wavefront_poa->pattern_end_free,0);
+  if (wavefront_poa->text_end_free) return pattern_left;
+  const int text_left = wavefront_segment->text_segment->sequence_length -
+      EWAVEFRONT_H(k,offset) + wavefront_poa->reduction_text_left[wavefront_segment->index];
+  return MAX(pattern_left,text_left);
+}
+/*
+ * Reduce
+ */
+int edit_wavefront_segment_reduce(
+    edit_wavefront_poa_t* const wavefront_poa,
+    edit_wavefront_segment_t* const wavefront_segment,
+    const int distance,
+    const int bound) {
+  // Fetch wavefront
+  edit_wavefront_t* const wavefront =
+      edit_wavefront_segment_get_wavefront(wavefront_segment,distance);
+  if (wavefront == NULL) return 0;
+  if (wavefront->hi-wavefront->lo+1 < wavefront_poa->reduction_min_wavefront_length) return 0;
+  const ewf_offset_t* const offsets = wavefront->offsets;
+  // Trim diagonals from both ends (null offsets are trimmed as well)
+  int num_reduced = 0;
+  while (wavefront->lo <= wavefront->hi) {
+    const int k = wavefront->lo;
+    if (offsets[k] >= 0) {
+      if (edit_wavefront_poa_reduction_estimate(wavefront_poa,wavefront_segment,k,offsets[k]) <= bound) break;
+      ++num_reduced;
+    }
+    ++(wavefront->lo);
+  }
+  while (wavefront->lo <= wavefront->hi) {
+    const int k = wavefront->hi;
+    if (offsets[k] >= 0) {
+      if (edit_wavefront_poa_reduction_estimate(wavefront_poa,wavefront_segment,k,offsets[k]) <= bound) break;
+      ++num_reduced;
+    }
+    --(wavefront->hi);
+  }
+  // Return valid offsets reduced
+  return num_reduced;
+}
+void edit_wavefront_poa_reduce(
+    edit_wavefront_poa_t* const wavefront_poa,
+    const int distance) {
+  // Parameters
+  edit_wavefront_segment_t** const wavefront_segments = wavefront_poa->wavefront_segments;
+  int* const next_active_segments = wavefront_poa->next_active_segments;
+  const int num_next_active_segments = wavefront_poa->num_next_active_segments;
+  int i, k;
+  // Compute best estimate (across all active segments)
+  int min_estimate = INT_MAX;
+  for (i=0;i<num_next_active_segments;++i) {
+    edit_wavefront_segment_t* const wavefront_segment = wavefront_segments[next_active_segments[i]];
+    edit_wavefront_t* const wavefront = edit_wavefront_segment_get_wavefront(wavefront_segment,distance);
+    if (wavefront == NULL) continue;
+    for (k=wavefront->lo;k<=wavefront->hi;++k) {
+      if (wavefront->offsets[k] < 0) continue;
+      const int estimate = edit_wavefront_poa_reduction_estimate(
+          wavefront_poa,wavefront_segment,k,wavefront->offsets[k]);
+      min_estimate = MIN(min_estimate,estimate);
+    }
+  }
+  // Store bound (replayed on checkpoint recomputation)
+  const int bound = (min_estimate == INT_MAX) ? INT_MAX :
+      min_estimate + wavefront_poa->reduction_max_distance_threshold;
+  vector_t* const reduction_bounds = wavefront_poa->reduction_bounds;
+  vector_reserve(reduction_bounds,distance+1,false);
+  vector_get_mem(reduction_bounds,int)[distance] = bound;
+  vector_set_used(reduction_bounds,distance+1);
+  // Reduce wavefronts
+  for (i=0;i<num_next_active_segments;++i) {
+    edit_wavefront_segment_t* const wavefront_segment = wavefront_segments[next_active_segments[i]];
+    wavefront_segment->num_valid_offsets -=
+        edit_wavefront_segment_reduce(wavefront_poa,wavefront_segment,distance,bound);
+  }
+}
+int edit_wavefront_poa_reduction_get_bound(
+    edit_wavefront_poa_t* const wavefront_poa,
+    const int distance) {
+  // Fetch bound (none if the distance was not reduced)
+  vector_t* const reduction_bounds = wavefront_poa->reduction_bounds;
+  if (!wavefront_poa->reduction || distance >= vector_get_used(reduction_bounds)) return INT_MAX;
+  return vector_get_mem(reduction_bounds,int)[distance];
+}
@@ -0,0 +1,66 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignments Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignments Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: Adaptive reduction of the Edit Wavefront-POA (heuristic)
+ */
+
+#ifndef EDIT_WAVEFRONT_REDUCTION_H_
+#define EDIT_WAVEFRONT_REDUCTION_H_
+
+#include "edit_wavefront_poa.h"
+
+/*
+ * Adaptive reduction
+ *   After extending each distance, the distance left to the end of the alignment is
+ *   estimated for every offset (text left down to the sink and pattern left). Diagonals
+ *   falling more than max-distance-threshold behind the best estimate of all active
+ *   segments are trimmed from both ends of their wavefront (wavefronts shorter than
+ *   min-wavefront-length are kept). Bounds are kept per distance to replay the
+ *   reduction when recomputing from checkpoints
+ */
+void edit_wavefront_poa_reduction_init(
+    edit_wavefront_poa_t* const wavefront_poa,
+    text_dag_t* const text_dag);
+int edit_wavefront_poa_reduction_estimate(
+    edit_wavefront_poa_t* const wavefront_poa,
+    edit_wavefront_segment_t* const wavefront_segment,
+    const int k,
+    const int offset);
+int edit_wavefront_segment_reduce(
+    edit_wavefront_poa_t* const wavefront_poa,
+    edit_wavefront_segment_t* const wavefront_segment,
+    const int distance,
+    const int bound);
+void edit_wavefront_poa_reduce(
+    edit_wavefront_poa_t* const wavefront_poa,
+    const int distance);
+int edit_wavefront_poa_reduction_get_bound(
+    edit_wavefront_poa_t* const wavefront_poa,
+    const int distance);
+
+#endif /* EDIT_WAVEFRONT_REDUCTION_H_ */
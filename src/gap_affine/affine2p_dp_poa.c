@@ -0,0 +1,282 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of WFPOA.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Partial Order Alignment Wavefront Alignment (WFPOA)
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: Dynamic-programming algorithm to compute partial order
+ *              alignment (POA) using dual-cost gap-affine penalties
+ */
+
+#include "affine2p_dp_poa.h"
+#include "alignment/score_matrix.h"
+
+/*
+ * Score-matrices (per segment)
+ */
+typedef enum {
+  affine2p_matrix_M  = 0, // Match/Mismatch (best of all)
+  affine2p_matrix_I1 = 1, // Insertion (text consumed)
+  affine2p_matrix_D1 = 2, // Deletion (pattern consumed)
+  affine2p_matrix_I2 = 3, // Insertion (second gap-affine piece)
+  affine2p_matrix_D2 = 4, // Deletion (second gap-affine piece)
+} affine2p_matrix_type;
+#define AFFINE2P_DP_POA_MATRICES 5
+#define AFFINE2P_MATRIX_INSERTION(type) ((type)==affine2p_matrix_I1 || (type)==affine2p_matrix_I2)
+typedef struct {
+  score_matrix_t** matrices[AFFINE2P_DP_POA_MATRICES]; // Score-matrices (per type and segment)
+  int gap_open[AFFINE2P_DP_POA_MATRICES];              // Score to open a gap (O+E)
+  int gap_extend[AFFINE2P_DP_POA_MATRICES];            // Score to extend a gap (E)
+} affine2p_dp_poa_matrices_t;
+
+/*
+ * POA Backtrace (dual-cost gap-affine using dynamic programming)
+ */
+bool affine2p_dp_poa_backtrace_previous(
+    affine2p_dp_poa_matrices_t* const matrices,
+    text_dag_t* const text_dag,
+    text_dag_segment_t* const segment,
+    const affine2p_matrix_type state,
+    const int v,
+    int* const segment_idx) {
+  // Parameters
+  score_matrix_t** const state_matrices = matrices->matrices[state];
+  const int score = state_matrices[*segment_idx]->columns[0][v];
+  // Search the previous segment providing the score of the first column
+  int i;
+  for (i=0;i<segment->prev_total;++i) {
+    const int prev_idx = segment->prev[i];
+    const int prev_length = text_dag->segments_ts[prev_idx]->sequence_length;
+    if (state_matrices[prev_idx]->columns[prev_length][v] == score) {
+      *segment_idx = prev_idx;
+      return true;
+    }
+  }
+  return false;
+}
+affine2p_matrix_type affine2p_dp_poa_backtrace_gap(
+    affine2p_dp_poa_matrices_t* const matrices,
+    const int segment_idx,
+    const int h,
+    const int v,
+    const bool insertion) {
+  // Select the gap-matrix providing the M score
+  const int score = matrices->matrices[affine2p_matrix_M][segment_idx]->columns[h][v];
+  if (insertion) {
+    return (matrices->matrices[affine2p_matrix_I1][segment_idx]->columns[h][v] == score) ?
+        affine2p_matrix_I1 : affine2p_matrix_I2;
+  } else {
+    return (matrices->matrices[affine2p_matrix_D1][segment_idx]->columns[h][v] == score) ?
+        affine2p_matrix_D1 : affine2p_matrix_D2;
+  }
+}
+void affine2p_dp_poa_backtrace(
+    affine2p_dp_poa_matrices_t* const matrices,
+    affine2p_penalties_t* const penalties,
+    const char* const pattern,
+    const int pattern_length,
+    text_dag_t* const text_dag,
+    cigar_t* const cigar) {
+  // Parameters
+  const int mismatch = penalties->mismatch;
+  char* const operations = cigar->operations;
+  // Clear CIGAR
+  cigar_clear(cigar);
+  // Backtrace from the last segment in the text-DAG (sink)
+  int segment_idx = text_dag->rank_to_segment_id[text_dag->segments_total-1];
+  int v = pattern_length;
+  affine2p_matrix_type state = affine2p_matrix_M;
+  while (true) {
+    // Fetch segment
+    text_dag_segment_t* const segment = text_dag->segments_ts[segment_idx];
+    const char* const text = segment->sequence;
+    int** const m_matrix = matrices->matrices[affine2p_matrix_M][segment_idx]->columns;
+    int h = segment->sequence_length;
+    // Backtrace segment-region (down to the first column)
+    while (h > 0) {
+      if (state == affine2p_matrix_M) {
+        const bool match = (v > 0 && text[h-1] == pattern[v-1]);
+        if (v > 0 && m_matrix[h][v] == m_matrix[h-1][v-1] + (match ? 0 : mismatch)) {
+          operations[--(cigar->begin_offset)] = match ? 'M' : 'X';
+          --h; --v;
+        } else {
+          const bool insertion =
+              (m_matrix[h][v] == matrices->matrices[affine2p_matrix_I1][segment_idx]->columns[h][v] ||
+               m_matrix[h][v] == matrices->matrices[affine2p_matrix_I2][segment_idx]->columns[h][v]);
+          state = affine2p_dp_poa_backtrace_gap(matrices,segment_idx,h,v,insertion);
+        }
+      } else if (AFFINE2P_MATRIX_INSERTION(state)) {
+        int** const i_matrix = matrices->matrices[state][segment_idx]->columns;
+        operations[--(cigar->begin_offset)] = 'I';
+        if (i_matrix[h][v] == m_matrix[h-1][v] + matrices->gap_open[state]) state = affine2p_matrix_M;
+        --h;
+      } else { // Deletion
+        int** const d_matrix = matrices->matrices[state][segment_idx]->columns;
+        operations[--(cigar->begin_offset)] = 'D';
+        if (d_matrix[h][v] == m_matrix[h][v-1] + matrices->gap_open[state]) state = affine2p_matrix_M;
+        --v;
+      }
+    }
+    // Backtrace first column (previous segment or deletions)
+    const bool source_segment = (segment->prev_total == 0);
+    const int current_idx = segment_idx;
+    while (true) {
+      if (!source_segment && affine2p_dp_poa_backtrace_previous(
+          matrices,text_dag,segment,state,v,&segment_idx)) break;
+      if (source_segment && state == affine2p_matrix_M && v == 0) break;
+      if (state == affine2p_matrix_M) {
+        state = affine2p_dp_poa_backtrace_gap(matrices,current_idx,0,v,false); // Deletions within the first column
+      } else { // Deletion
+        int** const d_matrix = matrices->matrices[state][current_idx]->columns;
+        operations[--(cigar->begin_offset)] = 'D';
+        if (d_matrix[0][v] == m_matrix[0][v-1] + matrices->gap_open[state]) state = affine2p_matrix_M;
+        --v;
+      }
+    }
+    cigar_add_segment(cigar,current_idx);
+    if (source_segment) break;
+  }
+}
+/*
+ * POA Dual-cost gap-affine computation using dynamic programming
+ */
+void affine2p_dp_poa_compute_segment(
+    affine2p_dp_poa_matrices_t* const matrices,
+    affine2p_penalties_t* const penalties,
+    const char* const pattern,
+    const int pattern_length,
+    text_dag_t* const text_dag,
+    const int segment_idx) {
+  // Parameters
+  const int mismatch = penalties->mismatch;
+  text_dag_segment_t* const segment = text_dag->segments_ts[segment_idx];
+  const int text_length = segment->sequence_length;
+  const char* const text = segment->sequence;
+  int** const m_matrix = matrices->matrices[affine2p_matrix_M][segment_idx]->columns;
+  int h, v, i, t;
+  // Init first column
+  if (segment->prev_total == 0) {
+    for (v=0;v<=pattern_length;++v) {
+      m_matrix[0][v] = (v==0) ? 0 : SCORE_MAX;
+      for (t=affine2p_matrix_I1;t<AFFINE2P_DP_POA_MATRICES;++t) {
+        int** const g_matrix = matrices->matrices[t][segment_idx]->columns;
+        g_matrix[0][v] = (v==0 || AFFINE2P_MATRIX_INSERTION(t)) ? SCORE_MAX :
+            (matrices->gap_open[t] - matrices->gap_extend[t]) + v*matrices->gap_extend[t];
+        m_matrix[0][v] = MIN(m_matrix[0][v],g_matrix[0][v]);
+      }
+    }
+  } else {
+    for (t=0;t<AFFINE2P_DP_POA_MATRICES;++t) {
+      int** const t_matrix = matrices->matrices[t][segment_idx]->columns;
+      for (v=0;v<=pattern_length;++v) t_matrix[0][v] = SCORE_MAX;
+      for (i=0;i<segment->prev_total;++i) {
+        const int prev_idx = segment->prev[i];
+        const int prev_length = text_dag->segments_ts[prev_idx]->sequence_length;
+        int* const prev_t = matrices->matrices[t][prev_idx]->columns[prev_length];
+        for (v=0;v<=pattern_length;++v) {
+          t_matrix[0][v] = MIN(t_matrix[0][v],prev_t[v]);
+        }
+      }
+    }
+    // Deletions within the first column (across previous segments)
+    int** const d1_matrix = matrices->matrices[affine2p_matrix_D1][segment_idx]->columns;
+    int** const d2_matrix = matrices->matrices[affine2p_matrix_D2][segment_idx]->columns;
+    for (v=1;v<=pattern_length;++v) {
+      const int del1 = MIN(m_matrix[0][v-1]+matrices->gap_open[affine2p_matrix_D1],
+                           d1_matrix[0][v-1]+matrices->gap_extend[affine2p_matrix_D1]);
+      const int del2 = MIN(m_matrix[0][v-1]+matrices->gap_open[affine2p_matrix_D2],
+                           d2_matrix[0][v-1]+matrices->gap_extend[affine2p_matrix_D2]);
+      d1_matrix[0][v] = MIN(d1_matrix[0][v],del1);
+      d2_matrix[0][v] = MIN(d2_matrix[0][v],del2);
+      m_matrix[0][v] = MIN(m_matrix[0][v],MIN(d1_matrix[0][v],d2_matrix[0][v]));
+    }
+  }
+  // Compute score-matrices for the segment-region
+  for (h=1;h<=text_length;++h) {
+    for (v=0;v<=pattern_length;++v) {
+      int min = (v > 0) ?
+          m_matrix[h-1][v-1] + ((text[h-1]==pattern[v-1]) ? 0 : mismatch) : SCORE_MAX; // Sub
+      for (t=affine2p_matrix_I1;t<AFFINE2P_DP_POA_MATRICES;++t) {
+        int** const g_matrix = matrices->matrices[t][segment_idx]->columns;
+        if (AFFINE2P_MATRIX_INSERTION(t)) { // Ins
+          g_matrix[h][v] = MIN(m_matrix[h-1][v]+matrices->gap_open[t],g_matrix[h-1][v]+matrices->gap_extend[t]);
+        } else { // Del
+          g_matrix[h][v] = (v > 0) ?
+              MIN(m_matrix[h][v-1]+matrices->gap_open[t],g_matrix[h][v-1]+matrices->gap_extend[t]) : SCORE_MAX;
+        }
+        min = MIN(min,g_matrix[h][v]);
+      }
+      m_matrix[h][v] = min;
+    }
+  }
+}
+void affine2p_dp_poa_compute(
+    affine2p_penalties_t* const penalties,
+    const char* const pattern,
+    const int pattern_length,
+    text_dag_t* const text_dag,
+    cigar_t* const cigar,
+    mm_allocator_t* const mm_allocator) {
+  // Parameters
+  const int segments_total = text_dag->segments_total;
+  affine2p_dp_poa_matrices_t matrices;
+  matrices.gap_open[affine2p_matrix_M] = 0;
+  matrices.gap_extend[affine2p_matrix_M] = 0;
+  matrices.gap_open[affine2p_matrix_I1] = penalties->gap_opening1 + penalties->gap_extension1;
+  matrices.gap_extend[affine2p_matrix_I1] = penalties->gap_extension1;
+  matrices.gap_open[affine2p_matrix_D1] = penalties->gap_opening1 + penalties->gap_extension1;
+  matrices.gap_extend[affine2p_matrix_D1] = penalties->gap_extension1;
+  matrices.gap_open[affine2p_matrix_I2] = penalties->gap_opening2 + penalties->gap_extension2;
+  matrices.gap_extend[affine2p_matrix_I2] = penalties->gap_extension2;
+  matrices.gap_open[affine2p_matrix_D2] = penalties->gap_opening2 + penalties->gap_extension2;
+  matrices.gap_extend[affine2p_matrix_D2] = penalties->gap_extension2;
+  // Allocate score-matrices
+  int i, t;
+  for (t=0;t<AFFINE2P_DP_POA_MATRICES;++t) {
+    matrices.matrices[t] = mm_allocator_calloc(mm_allocator,segments_total,score_matrix_t*,false);
+    for (i=0;i<segments_total;++i) {
+      const int text_length = text_dag->segments_ts[i]->sequence_length;
+      matrices.matrices[t][i] = score_matrix_new(pattern_length,text_length,mm_allocator);
+    }
+  }
+  // Compute score-matrices segment-wise (in topological order)
+  int rank;
+  for (rank=0;rank<segments_total;++rank) {
+    affine2p_dp_poa_compute_segment(&matrices,penalties,
+        pattern,pattern_length,text_dag,text_dag->rank_to_segment_id[rank]);
+  }
+  // Compute backtrace
+  affine2p_dp_poa_backtrace(&matrices,penalties,pattern,pattern_length,text_dag,cigar);
+  const int sink_idx = text_dag->rank_to_segment_id[segments_total-1];
+  const int sink_length = text_dag->segments_ts[sink_idx]->sequence_length;
+  cigar->score = matrices.matrices[affine2p_matrix_M][sink_idx]->columns[sink_length][pattern_length];
+  // Free
+  for (t=0;t<AFFINE2P_DP_POA_MATRICES;++t) {
+    for (i=0;i<segments_total;++i) {
+      score_matrix_delete(matrices.matrices[t][i]);
+    }
+    mm_allocator_free(mm_allocator,matrices.matrices[t]);
+  }
+}
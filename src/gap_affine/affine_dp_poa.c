@@ -0,0 +1,244 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of WFPOA.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Partial Order Alignment Wavefront Alignment (WFPOA)
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: Dynamic-programming algorithm to compute partial order
+ *              alignment (POA) using gap-affine penalties
+ */
+
+#include "affine_dp_poa.h"
+#include "alignment/score_matrix.h"
+
+/*
+ * Score-matrices (per segment)
+ */
+typedef struct {
+  score_matrix_t** m_matrices; // Match/Mismatch (best of all)
+  score_matrix_t** i_matrices; // Insertion (text consumed)
+  score_matrix_t** d_matrices; // Deletion (pattern consumed)
+} affine_dp_poa_matrices_t;
+
+/*
+ * POA Backtrace (gap-affine using dynamic programming)
+ */
+bool affine_dp_poa_backtrace_previous(
+    affine_dp_poa_matrices_t* const matrices,
+    text_dag_t* const text_dag,
+    text_dag_segment_t* const segment,
+    const int state,
+    const int v,
+    int* const segment_idx) {
+  // Parameters
+  score_matrix_t** const state_matrices = (state == 'M') ? matrices->m_matrices :
+      (state == 'I') ? matrices->i_matrices : matrices->d_matrices;
+  const int score = state_matrices[*segment_idx]->columns[0][v];
+  // Search the previous segment providing the score of the first column
+  int i;
+  for (i=0;i<segment->prev_total;++i) {
+    const int prev_idx = segment->prev[i];
+    const int prev_length = text_dag->segments_ts[prev_idx]->sequence_length;
+    if (state_matrices[prev_idx]->columns[prev_length][v] == score) {
+      *segment_idx = prev_idx;
+      return true;
+    }
+  }
+  return false;
+}
+void affine_dp_poa_backtrace(
+    affine_dp_poa_matrices_t* const matrices,
+    affine_penalties_t* const penalties,
+    const char* const pattern,
+    const int pattern_length,
+    text_dag_t* const text_dag,
+    cigar_t* const cigar) {
+  // Parameters
+  const int mismatch = penalties->mismatch;
+  const int gap_open = penalties->gap_opening + penalties->gap_extension;
+  char* const operations = cigar->operations;
+  // Clear CIGAR
+  cigar_clear(cigar);
+  // Backtrace from the last segment in the text-DAG (sink)
+  int segment_idx = text_dag->rank_to_segment_id[text_dag->segments_total-1];
+  int v = pattern_length, state = 'M';
+  while (true) {
+    // Fetch segment
+    text_dag_segment_t* const segment = text_dag->segments_ts[segment_idx];
+    const char* const text = segment->sequence;
+    int** const m_matrix = matrices->m_matrices[segment_idx]->columns;
+    int** const i_matrix = matrices->i_matrices[segment_idx]->columns;
+    int** const d_matrix = matrices->d_matrices[segment_idx]->columns;
+    int h = segment->sequence_length;
+    // Backtrace segment-region (down to the first column)
+    while (h > 0) {
+      if (state == 'M') {
+        const bool match = (v > 0 && text[h-1] == pattern[v-1]);
+        if (v > 0 && m_matrix[h][v] == m_matrix[h-1][v-1] + (match ? 0 : mismatch)) {
+          operations[--(cigar->begin_offset)] = match ? 'M' : 'X';
+          --h; --v;
+        } else {
+          state = (m_matrix[h][v] == i_matrix[h][v]) ? 'I' : 'D';
+        }
+      } else if (state == 'I') {
+        operations[--(cigar->begin_offset)] = 'I';
+        if (i_matrix[h][v] == m_matrix[h-1][v] + gap_open) state = 'M';
+        --h;
+      } else { // state == 'D'
+        operations[--(cigar->begin_offset)] = 'D';
+        if (d_matrix[h][v] == m_matrix[h][v-1] + gap_open) state = 'M';
+        --v;
+      }
+    }
+    // Backtrace first column (previous segment or deletions)
+    const bool source_segment = (segment->prev_total == 0);
+    const int current_idx = segment_idx;
+    while (true) {
+      if (!source_segment && affine_dp_poa_backtrace_previous(
+          matrices,text_dag,segment,state,v,&segment_idx)) break;
+      if (source_segment && state == 'M' && v == 0) break;
+      if (state == 'M') {
+        state = 'D'; // Deletions within the first column
+      } else { // state == 'D'
+        operations[--(cigar->begin_offset)] = 'D';
+        if (d_matrix[0][v] == m_matrix[0][v-1] + gap_open) state = 'M';
+        --v;
+      }
+    }
+    cigar_add_segment(cigar,current_idx);
+    if (source_segment) break;
+  }
+}
+/*
+ * POA Gap-affine computation using dynamic programming
+ */
+void affine_dp_poa_compute_segment(
+    affine_dp_poa_matrices_t* const matrices,
+    affine_penalties_t* const penalties,
+    const char* const pattern,
+    const int pattern_length,
+    text_dag_t* const text_dag,
+    const int segment_idx) {
+  // Parameters
+  const int mismatch = penalties->mismatch;
+  const int gap_open = penalties->gap_opening + penalties->gap_extension;
+  const int gap_extension = penalties->gap_extension;
+  text_dag_segment_t* const segment = text_dag->segments_ts[segment_idx];
+  const int text_length = segment->sequence_length;
+  const char* const text = segment->sequence;
+  int** const m_matrix = matrices->m_matrices[segment_idx]->columns;
+  int** const i_matrix = matrices->i_matrices[segment_idx]->columns;
+  int** const d_matrix = matrices->d_matrices[segment_idx]->columns;
+  int h, v, i;
+  // Init first column
+  if (segment->prev_total == 0) {
+    m_matrix[0][0] = 0;
+    i_matrix[0][0] = SCORE_MAX;
+    d_matrix[0][0] = SCORE_MAX;
+    for (v=1;v<=pattern_length;++v) {
+      i_matrix[0][v] = SCORE_MAX;
+      d_matrix[0][v] = penalties->gap_opening + v*gap_extension;
+      m_matrix[0][v] = d_matrix[0][v];
+    }
+  } else {
+    for (v=0;v<=pattern_length;++v) {
+      m_matrix[0][v] = SCORE_MAX;
+      i_matrix[0][v] = SCORE_MAX;
+      d_matrix[0][v] = SCORE_MAX;
+    }
+    for (i=0;i<segment->prev_total;++i) {
+      const int prev_idx = segment->prev[i];
+      const int prev_length = text_dag->segments_ts[prev_idx]->sequence_length;
+      int* const prev_m = matrices->m_matrices[prev_idx]->columns[prev_length];
+      int* const prev_i = matrices->i_matrices[prev_idx]->columns[prev_length];
+      int* const prev_d = matrices->d_matrices[prev_idx]->columns[prev_length];
+      for (v=0;v<=pattern_length;++v) {
+        m_matrix[0][v] = MIN(m_matrix[0][v],prev_m[v]);
+        i_matrix[0][v] = MIN(i_matrix[0][v],prev_i[v]);
+        d_matrix[0][v] = MIN(d_matrix[0][v],prev_d[v]);
+      }
+    }
+    // Deletions within the first column (across previous segments)
+    for (v=1;v<=pattern_length;++v) {
+      const int del = MIN(m_matrix[0][v-1]+gap_open,d_matrix[0][v-1]+gap_extension);
+      d_matrix[0][v] = MIN(d_matrix[0][v],del);
+      m_matrix[0][v] = MIN(m_matrix[0][v],d_matrix[0][v]);
+    }
+  }
+  // Compute score-matrices for the segment-region
+  for (h=1;h<=text_length;++h) {
+    i_matrix[h][0] = MIN(m_matrix[h-1][0]+gap_open,i_matrix[h-1][0]+gap_extension);
+    d_matrix[h][0] = SCORE_MAX;
+    m_matrix[h][0] = i_matrix[h][0];
+    for (v=1;v<=pattern_length;++v) {
+      i_matrix[h][v] = MIN(m_matrix[h-1][v]+gap_open,i_matrix[h-1][v]+gap_extension); // Ins
+      d_matrix[h][v] = MIN(m_matrix[h][v-1]+gap_open,d_matrix[h][v-1]+gap_extension); // Del
+      const int sub = m_matrix[h-1][v-1] + ((text[h-1]==pattern[v-1]) ? 0 : mismatch);
+      m_matrix[h][v] = MIN(sub,MIN(i_matrix[h][v],d_matrix[h][v]));
+    }
+  }
+}
+void affine_dp_poa_compute(
+    affine_penalties_t* const penalties,
+    const char* const pattern,
+    const int pattern_length,
+    text_dag_t* const text_dag,
+    cigar_t* const cigar,
+    mm_allocator_t* const mm_allocator) {
+  // Parameters
+  const int segments_total = text_dag->segments_total;
+  // Allocate score-matrices
+  affine_dp_poa_matrices_t matrices;
+  matrices.m_matrices = mm_allocator_calloc(mm_allocator,segments_total,score_matrix_t*,false);
+  matrices.i_matrices = mm_allocator_calloc(mm_allocator,segments_total,score_matrix_t*,false);
+  matrices.d_matrices = mm_allocator_calloc(mm_allocator,segments_total,score_matrix_t*,false);
+  int i;
+  for (i=0;i<segments_total;++i) {
+    const int text_length = text_dag->segments_ts[i]->sequence_length;
+    matrices.m_matrices[i] = score_matrix_new(pattern_length,text_length,mm_allocator);
+    matrices.i_matrices[i] = score_matrix_new(pattern_length,text_length,mm_allocator);
+    matrices.d_matrices[i] = score_matrix_new(pattern_length,text_length,mm_allocator);
+  }
+  // Compute score-matrices segment-wise (in topological order)
+  int rank;
+  for (rank=0;rank<segments_total;++rank) {
+    affine_dp_poa_compute_segment(&matrices,penalties,
+        pattern,pattern_length,text_dag,text_dag->rank_to_segment_id[rank]);
+  }
+  // Compute backtrace
+  affine_dp_poa_backtrace(&matrices,penalties,pattern,pattern_length,text_dag,cigar);
+  const int sink_idx = text_dag->rank_to_segment_id[segments_total-1];
+  const int sink_length = text_dag->segments_ts[sink_idx]->sequence_length;
+  cigar->score = matrices.m_matrices[sink_idx]->columns[sink_length][pattern_length];
+  // Free
+  for (i=0;i<segments_total;++i) {
+    score_matrix_delete(matrices.m_matrices[i]);
+    score_matrix_delete(matrices.i_matrices[i]);
+    score_matrix_delete(matrices.d_matrices[i]);
+  }
+  mm_allocator_free(mm_allocator,matrices.d_matrices);
+  mm_allocator_free(mm_allocator,matrices.i_matrices);
+  mm_allocator_free(mm_allocator,matrices.m_matrices);
+}
@@ -0,0 +1,431 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of WFPOA.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Partial Order Alignment Wavefront Alignment (WFPOA)
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: Gap-affine based wavefront alignment algorithm (POA)
+ */
+
+#include "affine_wavefront_poa.h"
+
+/*
+ * Constants
+ */
+#define AFFINE_WF_POA_SEGMENT_SETS_INIT     16
+#define AFFINE_WF_POA_SEGMENT_CONTROLS_INIT 16
+
+#define AFFINE_WF_CONTROL_EMPTY INT_MIN
+#define AFFINE_WF_CONTROL_KEY(k,component) ((k)*AFFINE_WAVEFRONT_COMPONENTS+(int)(component))
+#define AFFINE_WF_CONTROL_HASH(key) ((uint32_t)(key)*2654435761u) // Fibonacci hashing
+
+/*
+ * Individual Affine Wavefront
+ */
+affine_wavefront_t* affine_wavefront_new(
+    const int lo_max,
+    const int hi_max,
+    const int lo,
+    const int hi,
+    mm_allocator_t* const mm_allocator) {
+  // Allocate
+  affine_wavefront_t* const wavefront = mm_allocator_alloc(mm_allocator,affine_wavefront_t);
+  // Offsets
+  const int wavefront_length = hi_max - lo_max + 1; // (+1) for k=0
+  wavefront->offsets_mem = mm_allocator_calloc(
+      mm_allocator,wavefront_length,awf_offset_t,false);
+  wavefront->offsets = wavefront->offsets_mem - lo_max; // Center at k=0
+  wavefront->lo_max = lo_max;
+  wavefront->hi_max = hi_max;
+  wavefront->lo = lo;
+  wavefront->hi = hi;
+  // Return
+  return wavefront;
+}
+void affine_wavefront_delete(
+    affine_wavefront_t* const wavefront,
+    mm_allocator_t* const mm_allocator) {
+  // Free
+  mm_allocator_free(mm_allocator,wavefront->offsets_mem);
+  mm_allocator_free(mm_allocator,wavefront);
+}
+awf_offset_t affine_wavefront_get_offset(
+    affine_wavefront_t* const wavefront,
+    const int k) {
+  // Check wavefront and diagonal
+  if (wavefront == NULL || k < wavefront->lo || k > wavefront->hi) return AWAVEFRONT_OFFSET_NULL;
+  return wavefront->offsets[k];
+}
+/*
+ * Affine Wavefront-Segments
+ */
+affine_wavefront_segment_t* affine_wavefront_segment_new(
+    char* const pattern,
+    const int pattern_length,
+    text_dag_segment_t* const text_segment,
+    mm_allocator_t* const mm_allocator) {
+  // Allocate
+  affine_wavefront_segment_t* const wavefront_segment =
+      mm_allocator_alloc(mm_allocator,affine_wavefront_segment_t);
+  // Sequences
+  wavefront_segment->pattern = pattern;
+  wavefront_segment->pattern_length = pattern_length;
+  wavefront_segment->text_segment = text_segment;
+  // Wavefronts (allocated on demand)
+  wavefront_segment->wavefront_sets = NULL;
+  wavefront_segment->wavefront_sets_allocated = 0;
+  wavefront_segment->score_min = -1;
+  wavefront_segment->score_max = -1;
+  wavefront_segment->score_last = -1;
+  // Control (allocated on demand)
+  wavefront_segment->controls = NULL;
+  wavefront_segment->controls_allocated = 0;
+  wavefront_segment->num_controls = 0;
+  wavefront_segment->active = false;
+  // MM
+  wavefront_segment->mm_allocator = mm_allocator;
+  // Return
+  return wavefront_segment;
+}
+void affine_wavefront_segment_delete(
+    affine_wavefront_segment_t* const wavefront_segment) {
+  // Parameters
+  mm_allocator_t* const mm_allocator = wavefront_segment->mm_allocator;
+  // Free wavefronts
+  if (wavefront_segment->wavefront_sets != NULL) {
+    const int num_sets = wavefront_segment->score_max - wavefront_segment->score_min + 1;
+    int i, c;
+    for (i=0;i<num_sets;++i) {
+      for (c=0;c<AFFINE_WAVEFRONT_COMPONENTS;++c) {
+        affine_wavefront_t* const wavefront = wavefront_segment->wavefront_sets[i].wavefronts[c];
+        if (wavefront != NULL) affine_wavefront_delete(wavefront,mm_allocator);
+      }
+    }
+    mm_allocator_free(mm_allocator,wavefront_segment->wavefront_sets);
+  }
+  // Free control
+  if (wavefront_segment->controls != NULL) mm_allocator_free(mm_allocator,wavefront_segment->controls);
+  mm_allocator_free(mm_allocator,wavefront_segment);
+}
+affine_wavefront_t* affine_wavefront_segment_get_wavefront(
+    affine_wavefront_segment_t* const wavefront_segment,
+    const int score,
+    const affine_wavefront_component_t component) {
+  // Check score within range
+  if (score < wavefront_segment->score_min || score > wavefront_segment->score_max) return NULL;
+  return wavefront_segment->wavefront_sets[score-wavefront_segment->score_min].wavefronts[component];
+}
+void affine_wavefront_segment_set_wavefront(
+    affine_wavefront_segment_t* const wavefront_segment,
+    const int score,
+    const affine_wavefront_component_t component,
+    affine_wavefront_t* const wavefront) {
+  // Parameters
+  mm_allocator_t* const mm_allocator = wavefront_segment->mm_allocator;
+  // First wavefront-set
+  if (wavefront_segment->wavefront_sets == NULL) {
+    wavefront_segment->wavefront_sets = mm_allocator_calloc(mm_allocator,
+        AFFINE_WF_POA_SEGMENT_SETS_INIT,affine_wavefront_set_t,true);
+    wavefront_segment->wavefront_sets_allocated = AFFINE_WF_POA_SEGMENT_SETS_INIT;
+    wavefront_segment->score_min = score;
+    wavefront_segment->score_max = score;
+  }
+  // Grow wavefront-sets (scores only increase)
+  const int score_min = wavefront_segment->score_min;
+  if (score-score_min >= wavefront_segment->wavefront_sets_allocated) {
+    int sets_allocated = 2*wavefront_segment->wavefront_sets_allocated;
+    while (score-score_min >= sets_allocated) sets_allocated *= 2;
+    affine_wavefront_set_t* const wavefront_sets = mm_allocator_calloc(mm_allocator,
+        sets_allocated,affine_wavefront_set_t,true);
+    memcpy(wavefront_sets,wavefront_segment->wavefront_sets,
+        (wavefront_segment->score_max-score_min+1)*sizeof(affine_wavefront_set_t));
+    mm_allocator_free(mm_allocator,wavefront_segment->wavefront_sets);
+    wavefront_segment->wavefront_sets = wavefront_sets;
+    wavefront_segment->wavefront_sets_allocated = sets_allocated;
+  }
+  // Set wavefront
+  wavefront_segment->wavefront_sets[score-score_min].wavefronts[component] = wavefront;
+  wavefront_segment->score_max = MAX(wavefront_segment->score_max,score);
+  if (wavefront != NULL) {
+    wavefront_segment->score_last = MAX(wavefront_segment->score_last,score);
+  }
+}
+affine_wavefront_t* affine_wavefront_segment_new_wavefront(
+    affine_wavefront_segment_t* const wavefront_segment,
+    const int lo,
+    const int hi) {
+  // Allocate the live diagonals (plus slack) within the segment diagonals
+  const int k_min = -wavefront_segment->pattern_length;
+  const int k_max = wavefront_segment->text_segment->sequence_length;
+  return affine_wavefront_new(
+      MAX(MIN(lo,k_max)-AWAVEFRONT_SLACK,k_min),
+      MIN(MAX(hi,k_min)+AWAVEFRONT_SLACK,k_max),
+      lo,hi,wavefront_segment->mm_allocator);
+}
+void affine_wavefront_segment_reserve_wavefront(
+    affine_wavefront_segment_t* const wavefront_segment,
+    affine_wavefront_t* const wavefront,
+    const int k) {
+  // Check diagonal already allocated
+  if (wavefront->lo_max <= k && k <= wavefront->hi_max) return;
+  // Parameters
+  mm_allocator_t* const mm_allocator = wavefront_segment->mm_allocator;
+  const int k_min = -wavefront_segment->pattern_length;
+  const int k_max = wavefront_segment->text_segment->sequence_length;
+  const int growth = MAX(AWAVEFRONT_SLACK,(wavefront->hi_max-wavefront->lo_max+1)/2);
+  const int lo_max = (k < wavefront->lo_max) ? MAX(k-growth,k_min) : wavefront->lo_max;
+  const int hi_max = (k > wavefront->hi_max) ? MIN(k+growth,k_max) : wavefront->hi_max;
+  // Allocate wider offsets (and copy the live diagonals)
+  awf_offset_t* const offsets_mem = mm_allocator_calloc(
+      mm_allocator,hi_max-lo_max+1,awf_offset_t,false);
+  awf_offset_t* const offsets = offsets_mem - lo_max;
+  if (wavefront->lo <= wavefront->hi) {
+    memcpy(offsets+wavefront->lo,wavefront->offsets+wavefront->lo,
+        (wavefront->hi-wavefront->lo+1)*sizeof(awf_offset_t));
+  }
+  mm_allocator_free(mm_allocator,wavefront->offsets_mem);
+  wavefront->offsets_mem = offsets_mem;
+  wavefront->offsets = offsets;
+  wavefront->lo_max = lo_max;
+  wavefront->hi_max = hi_max;
+}
+/*
+ * Affine Wavefront-Segments Control
+ */
+affine_wavefront_control_t* affine_wavefront_segment_get_control(
+    affine_wavefront_segment_t* const wavefront_segment,
+    const int k,
+    const affine_wavefront_component_t component) {
+  // Check controls
+  if (wavefront_segment->num_controls == 0) return NULL;
+  // Probe (linear)
+  affine_wavefront_control_t* const controls = wavefront_segment->controls;
+  const int key = AFFINE_WF_CONTROL_KEY(k,component);
+  const uint32_t mask = wavefront_segment->controls_allocated - 1;
+  uint32_t pos = AFFINE_WF_CONTROL_HASH(key) & mask;
+  while (controls[pos].key != AFFINE_WF_CONTROL_EMPTY) {
+    if (controls[pos].key == key) return controls + pos;
+    pos = (pos+1) & mask;
+  }
+  return NULL;
+}
+void affine_wavefront_segment_controls_resize(
+    affine_wavefront_segment_t* const wavefront_segment,
+    const int controls_allocated) {
+  // Parameters
+  mm_allocator_t* const mm_allocator = wavefront_segment->mm_allocator;
+  affine_wavefront_control_t* const controls_old = wavefront_segment->controls;
+  const int controls_allocated_old = wavefront_segment->controls_allocated;
+  // Allocate
+  affine_wavefront_control_t* const controls = mm_allocator_calloc(
+      mm_allocator,controls_allocated,affine_wavefront_control_t,false);
+  const uint32_t mask = controls_allocated - 1;
+  int i;
+  for (i=0;i<controls_allocated;++i) controls[i].key = AFFINE_WF_CONTROL_EMPTY;
+  // Rehash
+  for (i=0;i<controls_allocated_old;++i) {
+    if (controls_old[i].key == AFFINE_WF_CONTROL_EMPTY) continue;
+    uint32_t pos = AFFINE_WF_CONTROL_HASH(controls_old[i].key) & mask;
+    while (controls[pos].key != AFFINE_WF_CONTROL_EMPTY) pos = (pos+1) & mask;
+    controls[pos] = controls_old[i];
+  }
+  if (controls_old != NULL) mm_allocator_free(mm_allocator,controls_old);
+  wavefront_segment->controls = controls;
+  wavefront_segment->controls_allocated = controls_allocated;
+}
+affine_wavefront_control_t* affine_wavefront_segment_add_control(
+    affine_wavefront_segment_t* const wavefront_segment,
+    const int k,
+    const affine_wavefront_component_t component) {
+  // Check existing control
+  affine_wavefront_control_t* const control =
+      affine_wavefront_segment_get_control(wavefront_segment,k,component);
+  if (control != NULL) return control;
+  // Grow (keep load factor below 1/2)
+  if (2*(wavefront_segment->num_controls+1) > wavefront_segment->controls_allocated) {
+    const int controls_allocated = (wavefront_segment->controls_allocated == 0) ?
+        AFFINE_WF_POA_SEGMENT_CONTROLS_INIT : 2*wavefront_segment->controls_allocated;
+    affine_wavefront_segment_controls_resize(wavefront_segment,controls_allocated);
+  }
+  // Insert
+  affine_wavefront_control_t* const controls = wavefront_segment->controls;
+  const int key = AFFINE_WF_CONTROL_KEY(k,component);
+  const uint32_t mask = wavefront_segment->controls_allocated - 1;
+  uint32_t pos = AFFINE_WF_CONTROL_HASH(key) & mask;
+  while (controls[pos].key != AFFINE_WF_CONTROL_EMPTY) pos = (pos+1) & mask;
+  controls[pos].key = key;
+  ++(wavefront_segment->num_controls);
+  return controls + pos;
+}
+/*
+ * Affine Wavefront-POA Setup
+ */
+affine_wavefront_poa_t* affine_wavefront_poa_new(
+    affine_penalties_t* const penalties,
+    mm_allocator_t* const mm_allocator) {
+  // Allocate
+  affine_wavefront_poa_t* const wavefront_poa =
+      mm_allocator_alloc(mm_allocator,affine_wavefront_poa_t);
+  // Penalties (gap-affine)
+  affine2p_penalties_t penalties_2p = {
+      .mismatch = penalties->mismatch,
+      .gap_opening1 = penalties->gap_opening,
+      .gap_extension1 = penalties->gap_extension,
+      .gap_opening2 = penalties->gap_opening,
+      .gap_extension2 = penalties->gap_extension,
+  };
+  affine_wavefront_poa_set_penalties_2p(wavefront_poa,&penalties_2p);
+  wavefront_poa->distance_metric = affine_wavefront_poa_gap_affine;
+  wavefront_poa->num_components = 3;
+  // Segment wavefronts (sized to the text-DAG on alignment)
+  wavefront_poa->wavefront_segments = NULL;
+  wavefront_poa->wavefront_segments_allocated = 0;
+  // Active wavefront-segments
+  wavefront_poa->active_segments = NULL;
+  wavefront_poa->num_active_segments = 0;
+  wavefront_poa->segment_id_to_rank = NULL;
+  // Alignment
+  wavefront_poa->alignment_score = -1;
+  // MM
+  wavefront_poa->mm_allocator = mm_allocator;
+  // Return
+  return wavefront_poa;
+}
+void affine_wavefront_poa_set_penalties_2p(
+    affine_wavefront_poa_t* const wavefront_poa,
+    affine2p_penalties_t* const penalties) {
+  // Set penalties (dual-cost gap-affine)
+  wavefront_poa->distance_metric = affine_wavefront_poa_gap_affine_2p;
+  wavefront_poa->penalties = *penalties;
+  wavefront_poa->num_components = 5;
+  // Set gap-components scores
+  wavefront_poa->gap_open[affine_wavefront_M] = 0;
+  wavefront_poa->gap_extend[affine_wavefront_M] = 0;
+  wavefront_poa->gap_open[affine_wavefront_I1] = penalties->gap_opening1 + penalties->gap_extension1;
+  wavefront_poa->gap_extend[affine_wavefront_I1] = penalties->gap_extension1;
+  wavefront_poa->gap_open[affine_wavefront_D1] = penalties->gap_opening1 + penalties->gap_extension1;
+  wavefront_poa->gap_extend[affine_wavefront_D1] = penalties->gap_extension1;
+  wavefront_poa->gap_open[affine_wavefront_I2] = penalties->gap_opening2 + penalties->gap_extension2;
+  wavefront_poa->gap_extend[affine_wavefront_I2] = penalties->gap_extension2;
+  wavefront_poa->gap_open[affine_wavefront_D2] = penalties->gap_opening2 + penalties->gap_extension2;
+  wavefront_poa->gap_extend[affine_wavefront_D2] = penalties->gap_extension2;
+}
+void affine_wavefront_poa_clear(
+    affine_wavefront_poa_t* const wavefront_poa) {
+  // Free wavefront-segments (of the previous alignment)
+  int i;
+  for (i=0;i<wavefront_poa->wavefront_segments_allocated;++i) {
+    if (wavefront_poa->wavefront_segments[i] != NULL) {
+      affine_wavefront_segment_delete(wavefront_poa->wavefront_segments[i]);
+      wavefront_poa->wavefront_segments[i] = NULL;
+    }
+  }
+  wavefront_poa->num_active_segments = 0;
+}
+void affine_wavefront_poa_resize(
+    affine_wavefront_poa_t* const wavefront_poa,
+    text_dag_t* const text_dag) {
+  // Parameters
+  mm_allocator_t* const mm_allocator = wavefront_poa->mm_allocator;
+  const int segments_total = text_dag->segments_total;
+  // Clear previous alignment
+  affine_wavefront_poa_clear(wavefront_poa);
+  // Topological ranks
+  wavefront_poa->segment_id_to_rank = text_dag->segment_id_to_rank;
+  // Check allocated
+  if (wavefront_poa->wavefront_segments_allocated >= segments_total) return;
+  // Free
+  if (wavefront_poa->wavefront_segments != NULL) {
+    mm_allocator_free(mm_allocator,wavefront_poa->active_segments);
+    mm_allocator_free(mm_allocator,wavefront_poa->wavefront_segments);
+  }
+  // Allocate
+  wavefront_poa->wavefront_segments = mm_allocator_calloc(mm_allocator,
+      segments_total,affine_wavefront_segment_t*,true);
+  wavefront_poa->wavefront_segments_allocated = segments_total;
+  wavefront_poa->active_segments = mm_allocator_calloc(mm_allocator,segments_total,int,false);
+}
+void affine_wavefront_poa_delete(
+    affine_wavefront_poa_t* const wavefront_poa) {
+  // Parameters
+  mm_allocator_t* const mm_allocator = wavefront_poa->mm_allocator;
+  // Free
+  if (wavefront_poa->wavefront_segments != NULL) {
+    affine_wavefront_poa_clear(wavefront_poa);
+    mm_allocator_free(mm_allocator,wavefront_poa->active_segments);
+    mm_allocator_free(mm_allocator,wavefront_poa->wavefront_segments);
+  }
+  mm_allocator_free(mm_allocator,wavefront_poa);
+}
+/*
+ * Active Wavefront-Segments
+ *   Segments are kept sorted by topological rank, so that offsets connected into
+ *   a next-segment are extended later on within the same score.
+ */
+void affine_wavefront_poa_active_add(
+    affine_wavefront_poa_t* const wavefront_poa,
+    affine_wavefront_segment_t* const wavefront_segment) {
+  // Check already active
+  if (wavefront_segment->active) return;
+  wavefront_segment->active = true;
+  // Search position (binary search by rank)
+  int* const active_segments = wavefront_poa->active_segments;
+  int* const segment_id_to_rank = wavefront_poa->segment_id_to_rank;
+  const int rank = segment_id_to_rank[wavefront_segment->index];
+  int lo = 0, hi = wavefront_poa->num_active_segments;
+  while (lo < hi) {
+    const int mid = (lo+hi)/2;
+    if (segment_id_to_rank[active_segments[mid]] < rank) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  // Insert
+  memmove(active_segments+lo+1,active_segments+lo,
+      (wavefront_poa->num_active_segments-lo)*sizeof(int));
+  active_segments[lo] = wavefront_segment->index;
+  ++(wavefront_poa->num_active_segments);
+}
+void affine_wavefront_poa_active_retire(
+    affine_wavefront_poa_t* const wavefront_poa,
+    const int score) {
+  // Parameters
+  const int score_span = MAX(wavefront_poa->penalties.mismatch,
+      MAX(wavefront_poa->gap_open[affine_wavefront_I1],wavefront_poa->gap_open[affine_wavefront_I2]));
+  int* const active_segments = wavefront_poa->active_segments;
+  // Retire segments that cannot produce wavefronts past this score
+  int i, num_active_segments = 0;
+  for (i=0;i<wavefront_poa->num_active_segments;++i) {
+    affine_wavefront_segment_t* const wavefront_segment =
+        wavefront_poa->wavefront_segments[active_segments[i]];
+    if (wavefront_segment->score_last + score_span > score) {
+      active_segments[num_active_segments++] = active_segments[i];
+    } else {
+      wavefront_segment->active = false;
+    }
+  }
+  wavefront_poa->num_active_segments = num_active_segments;
+}
@@ -0,0 +1,228 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignments Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignments Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: Gap-affine based wavefront alignment algorithm (POA)
+ */
+
+#ifndef AFFINE_WAVEFRONT_POA_H_
+#define AFFINE_WAVEFRONT_POA_H_
+
+#include "utils/commons.h"
+#include "utils/text_dag.h"
+#include "system/mm_allocator.h"
+#include "alignment/affine_penalties.h"
+#include "alignment/affine2p_penalties.h"
+
+/*
+ * Translate k and offset to coordinates h,v
+ */
+#define AWAVEFRONT_V(k,offset) ((offset)-(k))
+#define AWAVEFRONT_H(k,offset) (offset)
+
+#define AWAVEFRONT_DIAGONAL(h,v) ((h)-(v))
+#define AWAVEFRONT_OFFSET(h,v)   (h)
+
+#define AWAVEFRONT_OFFSET_NULL (INT32_MIN/2)
+#define AWAVEFRONT_SLACK       8  // Diagonals allocated beyond the live range (room to connect/grow)
+
+/*
+ * Individual Affine Wavefront
+ */
+typedef int32_t awf_offset_t;  // Affine Wavefront Offset
+typedef enum {
+  affine_wavefront_M  = 0,     // Match/Mismatch (best of all components)
+  affine_wavefront_I1 = 1,     // Insertion (text consumed)
+  affine_wavefront_D1 = 2,     // Deletion (pattern consumed)
+  affine_wavefront_I2 = 3,     // Insertion (second gap-affine piece)
+  affine_wavefront_D2 = 4,     // Deletion (second gap-affine piece)
+} affine_wavefront_component_t;
+#define AFFINE_WAVEFRONT_COMPONENTS 5
+#define AFFINE_WAVEFRONT_INSERTION(component) \
+  ((component)==affine_wavefront_I1 || (component)==affine_wavefront_I2)
+typedef struct {
+  int segment_idx;
+  int score;
+  int k;
+  awf_offset_t offset;
+  affine_wavefront_component_t component;
+} affine_wavefront_locator_t;
+typedef struct {
+  int key;                     // Diagonal and component (AFFINE_WF_CONTROL_EMPTY if the slot is free)
+  affine_wavefront_locator_t previous_wf_end;  // Connected from (previous segment)
+  affine_wavefront_locator_t current_wf_begin; // Connected to (this segment)
+} affine_wavefront_control_t;
+typedef struct {
+  // Offsets memory
+  int lo_max;                  // Max allocated lowest diagonal (inclusive)
+  int hi_max;                  // Max allocated highest diagonal (inclusive)
+  awf_offset_t* offsets_mem;   // Offsets memory
+  // Offsets
+  int lo;                      // Effective lowest diagonal (inclusive)
+  int hi;                      // Effective highest diagonal (inclusive)
+  awf_offset_t* offsets;       // Offsets
+} affine_wavefront_t;
+typedef struct {
+  affine_wavefront_t* wavefronts[AFFINE_WAVEFRONT_COMPONENTS]; // Wavefront per component (NULL if none)
+} affine_wavefront_set_t;
+
+/*
+ * Affine Wavefront-Segments
+ */
+typedef struct {
+  // Index
+  int index;
+  // Sequences
+  char* pattern;
+  int pattern_length;
+  text_dag_segment_t* text_segment;
+  // Wavefronts (indexed by score, from score_min to score_max)
+  affine_wavefront_set_t* wavefront_sets; // Wavefront-sets memory (wavefront_sets[score-score_min])
+  int wavefront_sets_allocated;   // Total wavefront-set slots allocated
+  int score_min;                  // Lowest score with a wavefront-set (-1 if none)
+  int score_max;                  // Highest score with a wavefront-set (-1 if none)
+  int score_last;                 // Highest score with a live wavefront (-1 if none)
+  // Control
+  affine_wavefront_control_t* controls; // Sparse control of connected diagonals (hashed by key)
+  int controls_allocated;         // Total control slots allocated (power of 2)
+  int num_controls;               // Total control slots used
+  bool active;                    // Segment in the active list
+  // MM
+  mm_allocator_t* mm_allocator;
+} affine_wavefront_segment_t;
+
+/*
+ * Affine Wavefront-POA
+ */
+typedef enum {
+  affine_wavefront_poa_gap_affine = 0,     // Gap-affine (M,I1,D1)
+  affine_wavefront_poa_gap_affine_2p = 1,  // Dual-cost gap-affine (M,I1,D1,I2,D2)
+} affine_wavefront_poa_distance_t;
+typedef struct {
+  // Penalties
+  affine_wavefront_poa_distance_t distance_metric;
+  affine2p_penalties_t penalties;           // Gap-affine uses only the first gap piece
+  int num_components;                       // Wavefront components computed (3 or 5)
+  int gap_open[AFFINE_WAVEFRONT_COMPONENTS];   // Score to open a gap on each gap-component (O+E)
+  int gap_extend[AFFINE_WAVEFRONT_COMPONENTS]; // Score to extend a gap on each gap-component (E)
+  // Segment wavefronts
+  affine_wavefront_segment_t** wavefront_segments; // Wavefront-segments (indexed by segment-id)
+  int wavefront_segments_allocated;                 // Total wavefront-segment slots allocated
+  // Active wavefront-segments (segment-ids sorted by topological rank)
+  int* active_segments;           // Segments with live wavefronts (within the penalties span)
+  int num_active_segments;        // Total active segments
+  int* segment_id_to_rank;        // Topological rank of each segment (from the text-DAG)
+  // Alignment
+  int alignment_score;            // Score of the last alignment (-1 if none)
+  // MM
+  mm_allocator_t* mm_allocator;
+} affine_wavefront_poa_t;
+
+/*
+ * Individual Affine Wavefront
+ */
+affine_wavefront_t* affine_wavefront_new(
+    const int lo_max,
+    const int hi_max,
+    const int lo,
+    const int hi,
+    mm_allocator_t* const mm_allocator);
+void affine_wavefront_delete(
+    affine_wavefront_t* const wavefront,
+    mm_allocator_t* const mm_allocator);
+
+awf_offset_t affine_wavefront_get_offset(
+    affine_wavefront_t* const wavefront,
+    const int k);
+
+/*
+ * Affine Wavefront-Segments
+ */
+affine_wavefront_segment_t* affine_wavefront_segment_new(
+    char* const pattern,
+    const int pattern_length,
+    text_dag_segment_t* const text_segment,
+    mm_allocator_t* const mm_allocator);
+void affine_wavefront_segment_delete(
+    affine_wavefront_segment_t* const wavefront_segment);
+
+affine_wavefront_t* affine_wavefront_segment_get_wavefront(
+    affine_wavefront_segment_t* const wavefront_segment,
+    const int score,
+    const affine_wavefront_component_t component);
+void affine_wavefront_segment_set_wavefront(
+    affine_wavefront_segment_t* const wavefront_segment,
+    const int score,
+    const affine_wavefront_component_t component,
+    affine_wavefront_t* const wavefront);
+
+affine_wavefront_t* affine_wavefront_segment_new_wavefront(
+    affine_wavefront_segment_t* const wavefront_segment,
+    const int lo,
+    const int hi);
+void affine_wavefront_segment_reserve_wavefront(
+    affine_wavefront_segment_t* const wavefront_segment,
+    affine_wavefront_t* const wavefront,
+    const int k);
+
+affine_wavefront_control_t* affine_wavefront_segment_get_control(
+    affine_wavefront_segment_t* const wavefront_segment,
+    const int k,
+    const affine_wavefront_component_t component);
+affine_wavefront_control_t* affine_wavefront_segment_add_control(
+    affine_wavefront_segment_t* const wavefront_segment,
+    const int k,
+    const affine_wavefront_component_t component);
+
+/*
+ * Affine Wavefront-POA Setup
+ */
+affine_wavefront_poa_t* affine_wavefront_poa_new(
+    affine_penalties_t* const penalties,
+    mm_allocator_t* const mm_allocator);
+void affine_wavefront_poa_set_penalties_2p(
+    affine_wavefront_poa_t* const wavefront_poa,
+    affine2p_penalties_t* const penalties);
+void affine_wavefront_poa_resize(
+    affine_wavefront_poa_t* const wavefront_poa,
+    text_dag_t* const text_dag);
+void affine_wavefront_poa_clear(
+    affine_wavefront_poa_t* const wavefront_poa);
+void affine_wavefront_poa_delete(
+    affine_wavefront_poa_t* const wavefront_poa);
+
+/*
+ * Active Wavefront-Segments
+ */
+void affine_wavefront_poa_active_add(
+    affine_wavefront_poa_t* const wavefront_poa,
+    affine_wavefront_segment_t* const wavefront_segment);
+void affine_wavefront_poa_active_retire(
+    affine_wavefront_poa_t* const wavefront_poa,
+    const int score);
+
+#endif /* AFFINE_WAVEFRONT_POA_H_ */
@@ -0,0 +1,220 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of WFPOA.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Partial Order Alignment Wavefront Alignment (WFPOA)
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ */
+
+#include "affine_wavefront_poa_align.h"
+#include "affine_wavefront_poa_extend.h"
+#include "affine_wavefront_poa_backtrace.h"
+
+/*
+ * Affine Wavefront-POA compute next wavefront
+ */
+awf_offset_t affine_wavefront_segment_check_offset(
+    affine_wavefront_segment_t* const wavefront_segment,
+    const int k,
+    const awf_offset_t offset) {
+  // Check offset within the segment (0<=h<=text_length, 0<=v<=pattern_length)
+  const int v = AWAVEFRONT_V(k,offset);
+  if (offset < 0 || offset > wavefront_segment->text_segment->sequence_length ||
+      v < 0 || v > wavefront_segment->pattern_length) return AWAVEFRONT_OFFSET_NULL;
+  return offset;
+}
+affine_wavefront_t* affine_wavefront_segment_trim(
+    affine_wavefront_segment_t* const wavefront_segment,
+    affine_wavefront_t* const wavefront) {
+  // Trim null offsets at both ends
+  while (wavefront->lo <= wavefront->hi && wavefront->offsets[wavefront->lo] < 0) ++(wavefront->lo);
+  while (wavefront->lo <= wavefront->hi && wavefront->offsets[wavefront->hi] < 0) --(wavefront->hi);
+  if (wavefront->lo <= wavefront->hi) return wavefront;
+  // Free empty wavefront
+  affine_wavefront_delete(wavefront,wavefront_segment->mm_allocator);
+  return NULL;
+}
+affine_wavefront_t* affine_wavefront_segment_compute_gap(
+    affine_wavefront_poa_t* const wavefront_poa,
+    affine_wavefront_segment_t* const wavefront_segment,
+    const int score,
+    const affine_wavefront_component_t component) {
+  // Parameters (insertions come from diagonal k-1 and consume text, deletions from k+1)
+  const bool insertion = AFFINE_WAVEFRONT_INSERTION(component);
+  const int k_shift = insertion ? 1 : -1;
+  const int offset_shift = insertion ? 1 : 0;
+  const int k_min = -wavefront_segment->pattern_length;
+  const int k_max = wavefront_segment->text_segment->sequence_length;
+  // Fetch source wavefronts (open from M, extend from the same component)
+  affine_wavefront_t* const mwavefront_open = affine_wavefront_segment_get_wavefront(
+      wavefront_segment,score-wavefront_poa->gap_open[component],affine_wavefront_M);
+  affine_wavefront_t* const gwavefront_ext = affine_wavefront_segment_get_wavefront(
+      wavefront_segment,score-wavefront_poa->gap_extend[component],component);
+  if (mwavefront_open == NULL && gwavefront_ext == NULL) return NULL;
+  // Compute limits
+  int lo = INT_MAX, hi = INT_MIN;
+  if (mwavefront_open != NULL) { lo = mwavefront_open->lo; hi = mwavefront_open->hi; }
+  if (gwavefront_ext != NULL) { lo = MIN(lo,gwavefront_ext->lo); hi = MAX(hi,gwavefront_ext->hi); }
+  lo = MAX(lo+k_shift,k_min);
+  hi = MIN(hi+k_shift,k_max);
+  if (lo > hi) return NULL;
+  // Compute next gap-wavefront
+  affine_wavefront_t* const wavefront = affine_wavefront_segment_new_wavefront(wavefront_segment,lo,hi);
+  int k;
+  for (k=lo;k<=hi;++k) {
+    const awf_offset_t gap = MAX(
+        affine_wavefront_get_offset(mwavefront_open,k-k_shift),
+        affine_wavefront_get_offset(gwavefront_ext,k-k_shift)) + offset_shift;
+    wavefront->offsets[k] = affine_wavefront_segment_check_offset(wavefront_segment,k,gap);
+  }
+  return affine_wavefront_segment_trim(wavefront_segment,wavefront);
+}
+void affine_wavefront_segment_compute_next(
+    affine_wavefront_poa_t* const wavefront_poa,
+    affine_wavefront_segment_t* const wavefront_segment,
+    const int score) {
+  // Parameters
+  const int num_components = wavefront_poa->num_components;
+  // Compute next gap-wavefronts (I1,D1 and I2,D2 on dual-cost gap-affine)
+  affine_wavefront_t* wavefronts[AFFINE_WAVEFRONT_COMPONENTS];
+  int c;
+  for (c=affine_wavefront_I1;c<num_components;++c) {
+    wavefronts[c] = affine_wavefront_segment_compute_gap(wavefront_poa,wavefront_segment,score,c);
+  }
+  // Compute limits (M-wavefront)
+  affine_wavefront_t* const mwavefront_sub = affine_wavefront_segment_get_wavefront(
+      wavefront_segment,score-wavefront_poa->penalties.mismatch,affine_wavefront_M);
+  int lo = INT_MAX, hi = INT_MIN;
+  if (mwavefront_sub != NULL) { lo = mwavefront_sub->lo; hi = mwavefront_sub->hi; }
+  for (c=affine_wavefront_I1;c<num_components;++c) {
+    if (wavefronts[c] == NULL) continue;
+    lo = MIN(lo,wavefronts[c]->lo);
+    hi = MAX(hi,wavefronts[c]->hi);
+  }
+  // Compute next M-wavefront (best of mismatch and gaps)
+  wavefronts[affine_wavefront_M] = NULL;
+  if (lo <= hi) {
+    affine_wavefront_t* const mwavefront = affine_wavefront_segment_new_wavefront(wavefront_segment,lo,hi);
+    int k;
+    for (k=lo;k<=hi;++k) {
+      awf_offset_t max = affine_wavefront_segment_check_offset(wavefront_segment,k,
+          affine_wavefront_get_offset(mwavefront_sub,k) + 1);
+      for (c=affine_wavefront_I1;c<num_components;++c) {
+        max = MAX(max,affine_wavefront_get_offset(wavefronts[c],k));
+      }
+      mwavefront->offsets[k] = max;
+    }
+    wavefronts[affine_wavefront_M] = affine_wavefront_segment_trim(wavefront_segment,mwavefront);
+  }
+  // Set wavefronts
+  for (c=0;c<num_components;++c) {
+    if (wavefronts[c] != NULL) {
+      affine_wavefront_segment_set_wavefront(wavefront_segment,score,c,wavefronts[c]);
+    }
+  }
+}
+/*
+ * Affine Wavefront-POA gap-affine alignment
+ */
+void affine_wavefront_poa_align_init(
+    affine_wavefront_poa_t* const wavefront_poa,
+    char* const pattern,
+    const int pattern_length,
+    text_dag_t* const text_dag) {
+  // Size wavefront-segments to the text-DAG
+  affine_wavefront_poa_resize(wavefront_poa,text_dag);
+  // Fetch first segment (source of the topologically sorted text-DAG)
+  const int segment_idx = text_dag->rank_to_segment_id[0];
+  text_dag_segment_t* const segment = text_dag->segments_ts[segment_idx];
+  // Set initial wavefront-segment
+  affine_wavefront_segment_t* const wavefront_segment = affine_wavefront_segment_new(
+      pattern,pattern_length,segment,wavefront_poa->mm_allocator);
+  wavefront_segment->index = segment_idx;
+  wavefront_poa->wavefront_segments[segment_idx] = wavefront_segment;
+  // Set initial wavefront (and offset)
+  affine_wavefront_t* const wavefront =
+      affine_wavefront_segment_new_wavefront(wavefront_segment,0,0);
+  wavefront->offsets[0] = 0;
+  affine_wavefront_segment_set_wavefront(wavefront_segment,0,affine_wavefront_M,wavefront);
+  // Set initial active segment
+  affine_wavefront_poa_active_add(wavefront_poa,wavefront_segment);
+  wavefront_poa->alignment_score = -1;
+}
+bool affine_wavefront_poa_align_extend(
+    affine_wavefront_poa_t* const wavefront_poa,
+    text_dag_t* const text_dag,
+    const int score,
+    affine_wavefront_locator_t* const wf_alignment) {
+  // Extend active segments (in topological order, including the ones connected meanwhile)
+  int i;
+  for (i=0;i<wavefront_poa->num_active_segments;++i) {
+    const int segment_idx = wavefront_poa->active_segments[i];
+    affine_wavefront_segment_t* const wavefront_segment = wavefront_poa->wavefront_segments[segment_idx];
+    if (wavefront_segment->score_last != score) continue; // No wavefronts at this score
+    // Extend diagonally each wavefront point
+    const bool alignment_end = affine_wavefront_poa_segment_extend(
+        wavefront_poa,wavefront_segment,text_dag,score,wf_alignment);
+    if (alignment_end) {
+      wavefront_poa->alignment_score = score;
+      return true;
+    }
+  }
+  // No End-of-Alignment
+  return false;
+}
+void affine_wavefront_poa_align_compute_next(
+    affine_wavefront_poa_t* const wavefront_poa,
+    const int score) {
+  // Compute next wavefronts of the active segments
+  int i;
+  for (i=0;i<wavefront_poa->num_active_segments;++i) {
+    const int segment_idx = wavefront_poa->active_segments[i];
+    affine_wavefront_segment_compute_next(
+        wavefront_poa,wavefront_poa->wavefront_segments[segment_idx],score);
+  }
+}
+void affine_wavefront_poa_align(
+    affine_wavefront_poa_t* const wavefront_poa,
+    char* const pattern,
+    const int pattern_length,
+    text_dag_t* const text_dag,
+    cigar_t* const cigar) {
+  // Set initial wavefront-segment
+  affine_wavefront_poa_align_init(wavefront_poa,pattern,pattern_length,text_dag);
+  // Compute wavefronts for increasing score (across wavefront-segments)
+  affine_wavefront_locator_t wf_alignment;
+  int score = 0;
+  while (!affine_wavefront_poa_align_extend(wavefront_poa,text_dag,score,&wf_alignment)) {
+    affine_wavefront_poa_active_retire(wavefront_poa,score);
+    if (wavefront_poa->num_active_segments == 0) { // End of the text-DAG unreachable
+      cigar_clear(cigar);
+      return;
+    }
+    ++score;
+    affine_wavefront_poa_align_compute_next(wavefront_poa,score);
+  }
+  // Backtrace wavefronts
+  affine_wavefront_poa_backtrace(wavefront_poa,&wf_alignment,cigar);
+}
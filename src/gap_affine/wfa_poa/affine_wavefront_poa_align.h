@@ -0,0 +1,75 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignments Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignments Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ */
+
+#ifndef AFFINE_WAVEFRONT_ALIGN_H_
+#define AFFINE_WAVEFRONT_ALIGN_H_
+
+#include "affine_wavefront_poa.h"
+#include "alignment/cigar.h"
+
+/*
+ * Affine Wavefront-POA compute next wavefront
+ */
+awf_offset_t affine_wavefront_segment_check_offset(
+    affine_wavefront_segment_t* const wavefront_segment,
+    const int k,
+    const awf_offset_t offset);
+void affine_wavefront_segment_compute_next(
+    affine_wavefront_poa_t* const wavefront_poa,
+    affine_wavefront_segment_t* const wavefront_segment,
+    const int score);
+
+/*
+ * Affine Wavefront-POA gap-affine alignment
+ *   Each score computes the wavefronts of the active segments (compute_next) and
+ *   then extends them in topological order (extend)
+ */
+void affine_wavefront_poa_align_init(
+    affine_wavefront_poa_t* const wavefront_poa,
+    char* const pattern,
+    const int pattern_length,
+    text_dag_t* const text_dag);
+bool affine_wavefront_poa_align_extend(
+    affine_wavefront_poa_t* const wavefront_poa,
+    text_dag_t* const text_dag,
+    const int score,
+    affine_wavefront_locator_t* const wf_alignment);
+void affine_wavefront_poa_align_compute_next(
+    affine_wavefront_poa_t* const wavefront_poa,
+    const int score);
+
+void affine_wavefront_poa_align(
+    affine_wavefront_poa_t* const wavefront_poa,
+    char* const pattern,
+    const int pattern_length,
+    text_dag_t* const text_dag,
+    cigar_t* const cigar);
+
+#endif /* AFFINE_WAVEFRONT_ALIGN_H_ */
@@ -0,0 +1,172 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of WFPOA.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Partial Order Alignment Wavefront Alignment (WFPOA)
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ */
+
+#include "affine_wavefront_poa_backtrace.h"
+#include "affine_wavefront_poa_align.h"
+
+/*
+ * Backtrace Affine Wavefront-POA
+ */
+affine_wavefront_control_t* affine_wavefront_poa_backtrace_connected(
+    affine_wavefront_segment_t* const wavefront_segment,
+    const int score,
+    const int k,
+    const affine_wavefront_component_t component) {
+  // Fetch the connection that set the offset (injected at this very score)
+  affine_wavefront_control_t* const control =
+      affine_wavefront_segment_get_control(wavefront_segment,k,component);
+  return (control != NULL && control->current_wf_begin.score == score) ? control : NULL;
+}
+void affine_wavefront_poa_backtrace_segment(
+    affine_wavefront_poa_t* const wavefront_poa,
+    affine_wavefront_segment_t* const wavefront_segment,
+    affine_wavefront_locator_t* const wf_loc,
+    const bool source_segment,
+    cigar_t* const cigar) {
+  // Parameters
+  const int mismatch = wavefront_poa->penalties.mismatch;
+  const int num_components = wavefront_poa->num_components;
+  int score = wf_loc->score;
+  int k = wf_loc->k;
+  int offset = wf_loc->offset;
+  affine_wavefront_component_t component = wf_loc->component;
+  affine_wavefront_control_t* control = NULL;
+  int c;
+  // Parameters CIGAR
+  char* const cigar_operations = cigar->operations;
+  int cigar_offset = cigar->begin_offset;
+  // Backtrace
+  while (true) {
+    if (component == affine_wavefront_M) {
+      // Check begin of the segment (initial offset or connected from a previous segment)
+      if (source_segment) {
+        if (score == 0 && k == 0) break;
+      } else {
+        control = affine_wavefront_poa_backtrace_connected(wavefront_segment,score,k,affine_wavefront_M);
+        if (control != NULL) break;
+      }
+      // Fetch predecessors (mismatch or gap-components)
+      const awf_offset_t offset_sub = affine_wavefront_segment_check_offset(wavefront_segment,k,
+          affine_wavefront_get_offset(affine_wavefront_segment_get_wavefront(
+              wavefront_segment,score-mismatch,affine_wavefront_M),k) + 1);
+      awf_offset_t offset_max = offset_sub;
+      affine_wavefront_component_t component_max = affine_wavefront_M;
+      for (c=affine_wavefront_I1;c<num_components;++c) {
+        const awf_offset_t offset_gap = affine_wavefront_get_offset(
+            affine_wavefront_segment_get_wavefront(wavefront_segment,score,c),k);
+        if (offset_gap > offset_max) {
+          offset_max = offset_gap;
+          component_max = c;
+        }
+      }
+      // Add matches
+      const int num_matches = offset - offset_max;
+      int i;
+      for (i=0;i<num_matches;++i) {
+        cigar_operations[--cigar_offset] = 'M';
+      }
+      offset = offset_max;
+      // Add operation
+      if (component_max == affine_wavefront_M) {
+        cigar_operations[--cigar_offset] = 'X';
+        score -= mismatch;
+        --offset;
+      } else {
+        component = component_max;
+      }
+    } else if (AFFINE_WAVEFRONT_INSERTION(component)) {
+      // Check insertion connected from a previous segment
+      if (offset == 0) {
+        control = affine_wavefront_poa_backtrace_connected(wavefront_segment,score,k,component);
+        break;
+      }
+      // Fetch predecessors (open or extend)
+      const int gap_open = wavefront_poa->gap_open[component];
+      const awf_offset_t offset_open = affine_wavefront_get_offset(affine_wavefront_segment_get_wavefront(
+          wavefront_segment,score-gap_open,affine_wavefront_M),k-1) + 1;
+      cigar_operations[--cigar_offset] = 'I';
+      if (offset_open == offset) {
+        score -= gap_open;
+        component = affine_wavefront_M;
+      } else {
+        score -= wavefront_poa->gap_extend[component];
+      }
+      --k;
+      --offset;
+    } else { // Deletion
+      // Fetch predecessors (open or extend)
+      const int gap_open = wavefront_poa->gap_open[component];
+      const awf_offset_t offset_open = affine_wavefront_get_offset(affine_wavefront_segment_get_wavefront(
+          wavefront_segment,score-gap_open,affine_wavefront_M),k+1);
+      cigar_operations[--cigar_offset] = 'D';
+      if (offset_open == offset) {
+        score -= gap_open;
+        component = affine_wavefront_M;
+      } else {
+        score -= wavefront_poa->gap_extend[component];
+      }
+      ++k;
+    }
+  }
+  // Account for leading matches
+  int i;
+  for (i=0;i<offset;++i) {
+    cigar_operations[--cigar_offset] = 'M';
+  }
+  // Return wf-location (previous segment)
+  if (!source_segment) {
+    *wf_loc = control->previous_wf_end;
+  }
+  // Close CIGAR
+  cigar->begin_offset = cigar_offset;
+}
+void affine_wavefront_poa_backtrace(
+    affine_wavefront_poa_t* const wavefront_poa,
+    affine_wavefront_locator_t* const wf_alignment,
+    cigar_t* const cigar) {
+  // Parameters
+  affine_wavefront_segment_t** const wavefront_segments = wavefront_poa->wavefront_segments;
+  // Clear CIGAR
+  cigar_clear(cigar);
+  // Backtrace from alignment-segment back to the beginning of the text-DAG
+  affine_wavefront_locator_t wf_loc = *wf_alignment;
+  bool source_segment;
+  do {
+    // Backtrace segment-region
+    const int segment_idx = wf_loc.segment_idx;
+    affine_wavefront_segment_t* const wavefront_segment = wavefront_segments[segment_idx];
+    source_segment = (wavefront_segment->text_segment->prev_total == 0);
+    affine_wavefront_poa_backtrace_segment(
+        wavefront_poa,wavefront_segment,&wf_loc,source_segment,cigar);
+    // Add segment-idx to CIGAR
+    cigar_add_segment(cigar,segment_idx);
+  } while (!source_segment);
+  cigar->score = wavefront_poa->alignment_score;
+}
@@ -0,0 +1,129 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of WFPOA.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Partial Order Alignment Wavefront Alignment (WFPOA)
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ */
+
+#include "affine_wavefront_poa_connect.h"
+
+/*
+ * Connect wavefront-offset across segments
+ */
+void affine_wavefront_poa_connect_inject(
+    affine_wavefront_segment_t* const next_wavefront_segment,
+    const int score,
+    const int next_k,
+    const affine_wavefront_component_t component,
+    affine_wavefront_locator_t* const previous_wf_end) {
+  // Check diagonal already connected at a lower score (same offset, dominated)
+  affine_wavefront_control_t* const next_control =
+      affine_wavefront_segment_get_control(next_wavefront_segment,next_k,component);
+  if (next_control != NULL && next_control->current_wf_begin.score < score) return;
+  // Fetch wavefront
+  const int next_offset = 0;
+  bool set_offset = false;
+  affine_wavefront_t* next_wavefront =
+      affine_wavefront_segment_get_wavefront(next_wavefront_segment,score,component);
+  if (next_wavefront == NULL) {
+    next_wavefront = affine_wavefront_segment_new_wavefront(next_wavefront_segment,next_k,next_k);
+    affine_wavefront_segment_set_wavefront(next_wavefront_segment,score,component,next_wavefront);
+    set_offset = true;
+  } else {
+    affine_wavefront_segment_reserve_wavefront(next_wavefront_segment,next_wavefront,next_k);
+    set_offset = (next_k < next_wavefront->lo || next_k > next_wavefront->hi ||
+                  next_wavefront->offsets[next_k] < next_offset);
+  }
+  if (!set_offset) return;
+  // Fill gap in the wavefront (if any)
+  int j;
+  if (next_k > next_wavefront->hi) {
+    for (j=next_wavefront->hi+1;j<next_k;++j) {
+      next_wavefront->offsets[j] = AWAVEFRONT_OFFSET_NULL;
+    }
+    next_wavefront->hi = next_k;
+  } else if (next_k < next_wavefront->lo) {
+    for (j=next_k+1;j<next_wavefront->lo;++j) {
+      next_wavefront->offsets[j] = AWAVEFRONT_OFFSET_NULL;
+    }
+    next_wavefront->lo = next_k;
+  }
+  // Set offset
+  next_wavefront->offsets[next_k] = next_offset; // Same v on next-segment
+  // Set previous-segment end and current-segment begin locations
+  affine_wavefront_control_t* const control =
+      affine_wavefront_segment_add_control(next_wavefront_segment,next_k,component);
+  control->previous_wf_end = *previous_wf_end;
+  control->current_wf_begin.segment_idx = next_wavefront_segment->index;
+  control->current_wf_begin.score = score;
+  control->current_wf_begin.k = next_k;
+  control->current_wf_begin.offset = next_offset;
+  control->current_wf_begin.component = component;
+}
+void affine_wavefront_poa_connect_offset(
+    affine_wavefront_poa_t* const wavefront_poa,
+    affine_wavefront_segment_t* const wavefront_segment,
+    text_dag_t* const text_dag,
+    const int score,
+    const int k,
+    const awf_offset_t offset,
+    const affine_wavefront_component_t component) {
+  // Parameters
+  text_dag_segment_t* const text_segment = wavefront_segment->text_segment;
+  char* const pattern = wavefront_segment->pattern;
+  const int pattern_length = wavefront_segment->pattern_length;
+  affine_wavefront_locator_t previous_wf_end = {
+      .segment_idx = wavefront_segment->index,
+      .score = score,
+      .k = k,
+      .offset = offset,
+      .component = component,
+  };
+  // Check next-connecting segments and open wavefronts
+  //   Note that next-segments are posterior in the partial-ordered graph (higher rank)
+  //   Therefore, if connected, the next-segment will be extended later on within the same score
+  int i;
+  for (i=0;i<text_segment->next_total;++i) {
+    // Fetch next wavefront-segment
+    const int next_idx = text_segment->next[i];
+    if (wavefront_poa->wavefront_segments[next_idx] == NULL) {
+      wavefront_poa->wavefront_segments[next_idx] = affine_wavefront_segment_new(
+          pattern,pattern_length,text_dag->segments_ts[next_idx],wavefront_poa->mm_allocator);
+      wavefront_poa->wavefront_segments[next_idx]->index = next_idx;
+    }
+    affine_wavefront_segment_t* const next_wavefront_segment = wavefront_poa->wavefront_segments[next_idx];
+    affine_wavefront_poa_active_add(wavefront_poa,next_wavefront_segment);
+    // Connect offset (same v, at h=0)
+    const int next_v = AWAVEFRONT_V(k,(int)offset);
+    const int next_k = AWAVEFRONT_DIAGONAL(0,next_v);
+    affine_wavefront_poa_connect_inject(
+        next_wavefront_segment,score,next_k,component,&previous_wf_end);
+    if (component != affine_wavefront_M) { // Insertion (also opens M on the next-segment)
+      affine_wavefront_poa_connect_inject(
+          next_wavefront_segment,score,next_k,affine_wavefront_M,&previous_wf_end);
+    }
+  }
+}
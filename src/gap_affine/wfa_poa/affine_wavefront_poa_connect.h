@@ -0,0 +1,52 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignments Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignments Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ */
+
+#ifndef AFFINE_WAVEFRONT_CONNECT_H_
+#define AFFINE_WAVEFRONT_CONNECT_H_
+
+#include "affine_wavefront_poa.h"
+
+/*
+ * Connect wavefront-offset across segments
+ *   Offsets reaching the end of a segment (h=text_length) continue at the beginning
+ *   (h=0) of the next segments. Insertions keep their component (so the gap is not
+ *   opened twice) and also connect as M; deletions are not connected, as the next
+ *   segment recomputes them from the connected M offsets.
+ */
+void affine_wavefront_poa_connect_offset(
+    affine_wavefront_poa_t* const wavefront_poa,
+    affine_wavefront_segment_t* const wavefront_segment,
+    text_dag_t* const text_dag,
+    const int score,
+    const int k,
+    const awf_offset_t offset,
+    const affine_wavefront_component_t component);
+
+#endif /* AFFINE_WAVEFRONT_CONNECT_H_ */
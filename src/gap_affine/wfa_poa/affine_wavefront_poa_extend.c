@@ -0,0 +1,120 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of WFPOA.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Partial Order Alignment Wavefront Alignment (WFPOA)
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ */
+
+#include "affine_wavefront_poa_extend.h"
+#include "affine_wavefront_poa_connect.h"
+#include "edit/wfe_poa/edit_wavefront_poa_extend.h"
+
+/*
+ * Extend wavefront-segment
+ */
+void affine_wavefront_poa_segment_connect_insertions(
+    affine_wavefront_poa_t* const wavefront_poa,
+    affine_wavefront_segment_t* const wavefront_segment,
+    text_dag_t* const text_dag,
+    const int score) {
+  // Parameters
+  const int text_length = wavefront_segment->text_segment->sequence_length;
+  // Connect insertions reaching the end of the segment (the gap continues on the next segments)
+  int c;
+  for (c=affine_wavefront_I1;c<wavefront_poa->num_components;++c) {
+    if (!AFFINE_WAVEFRONT_INSERTION(c)) continue;
+    // Fetch wavefront
+    affine_wavefront_t* const iwavefront =
+        affine_wavefront_segment_get_wavefront(wavefront_segment,score,c);
+    if (iwavefront == NULL) continue;
+    awf_offset_t* const offsets = iwavefront->offsets;
+    int k;
+    for (k=iwavefront->lo;k<=iwavefront->hi;++k) {
+      if (offsets[k] == text_length) {
+        affine_wavefront_poa_connect_offset(wavefront_poa,
+            wavefront_segment,text_dag,score,k,offsets[k],c);
+      }
+    }
+  }
+}
+bool affine_wavefront_poa_segment_extend(
+    affine_wavefront_poa_t* const wavefront_poa,
+    affine_wavefront_segment_t* const wavefront_segment,
+    text_dag_t* const text_dag,
+    const int score,
+    affine_wavefront_locator_t* const wf_alignment) {
+  // Parameters
+  text_dag_segment_t* const text_segment = wavefront_segment->text_segment;
+  const char* const pattern = wavefront_segment->pattern;
+  const int pattern_length = wavefront_segment->pattern_length;
+  const char* const text = text_segment->sequence;
+  const int text_length = text_segment->sequence_length;
+  const bool sink_segment = (text_segment->next_total == 0);
+  // Connect insertions
+  if (!sink_segment) {
+    affine_wavefront_poa_segment_connect_insertions(
+        wavefront_poa,wavefront_segment,text_dag,score);
+  }
+  // Fetch wavefront
+  affine_wavefront_t* const mwavefront =
+      affine_wavefront_segment_get_wavefront(wavefront_segment,score,affine_wavefront_M);
+  if (mwavefront == NULL) return false;
+  awf_offset_t* const offsets = mwavefront->offsets;
+  // Extend diagonally each wavefront point
+  int k;
+  for (k=mwavefront->lo;k<=mwavefront->hi;++k) {
+    if (offsets[k] < 0) continue; // Null offset
+    // Locate offset and extend
+    int v = AWAVEFRONT_V(k,offsets[k]);
+    int h = AWAVEFRONT_H(k,offsets[k]);
+    const int num_matches = edit_wavefront_poa_extend_matches(
+        pattern,v,pattern_length,text,h,text_length);
+    offsets[k] += num_matches;
+    v += num_matches;
+    h += num_matches;
+    // Check end of segment
+    if (h == text_length) {
+      if (sink_segment) { // End-of-Graph
+        // Check end-of-alignment
+        if (v == pattern_length) {
+          wf_alignment->segment_idx = wavefront_segment->index;
+          wf_alignment->score = score;
+          wf_alignment->k = k;
+          wf_alignment->offset = offsets[k];
+          wf_alignment->component = affine_wavefront_M;
+          return true; // End-of-Pattern
+        }
+        continue; // Keep offset (pattern left to delete at the end of the graph)
+      }
+      // Connect with next-segments and close offset in current segment
+      affine_wavefront_poa_connect_offset(wavefront_poa,
+          wavefront_segment,text_dag,score,k,offsets[k],affine_wavefront_M);
+      offsets[k] = AWAVEFRONT_OFFSET_NULL;
+    }
+  }
+  // No End-of-Alignment
+  return false;
+}
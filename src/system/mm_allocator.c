@@ -157,6 +157,7 @@ void mm_allocator_clear(
   const uint64_t num_segments = vector_get_used(mm_allocator->segments);
   mm_allocator_segment_t** const segments = 
       vector_get_mem(mm_allocator->segments,mm_allocator_segment_t*);
+  mm_allocator_segment_clear(segments[0]); // Clear current segment
   uint64_t i;
   for (i=1;i<num_segments;++i) {
     mm_allocator_segment_clear(segments[i]); // Clear segment
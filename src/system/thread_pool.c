@@ -0,0 +1,162 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignments Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignments Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: Persistent pool of worker threads running indexed tasks
+ */
+
+#include "thread_pool.h"
+
+/*
+ * Workers
+ */
+typedef struct {
+  thread_pool_t* thread_pool;
+  int thread_idx;
+} thread_pool_worker_args_t;
+void thread_pool_run_tasks(
+    thread_pool_t* const thread_pool,
+    const int thread_idx) {
+  // Take tasks until none is left
+  while (true) {
+    const int task_idx = __atomic_fetch_add(&thread_pool->next_task,1,__ATOMIC_RELAXED);
+    if (task_idx >= thread_pool->num_tasks) break;
+    thread_pool->task(thread_pool->task_args,task_idx,thread_idx);
+  }
+}
+void* thread_pool_worker(
+    void* const args) {
+  // Parameters
+  thread_pool_worker_args_t* const worker_args = (thread_pool_worker_args_t*)args;
+  thread_pool_t* const thread_pool = worker_args->thread_pool;
+  const int thread_idx = worker_args->thread_idx;
+  free(worker_args);
+  // Serve jobs
+  uint64_t job_id = 0;
+  pthread_mutex_lock(&thread_pool->mutex);
+  while (true) {
+    // Wait for the next job
+    while (!thread_pool->shutdown && thread_pool->job_id == job_id) {
+      pthread_cond_wait(&thread_pool->job_ready,&thread_pool->mutex);
+    }
+    if (thread_pool->shutdown) break;
+    job_id = thread_pool->job_id;
+    pthread_mutex_unlock(&thread_pool->mutex);
+    // Run tasks
+    thread_pool_run_tasks(thread_pool,thread_idx);
+    // Signal done
+    pthread_mutex_lock(&thread_pool->mutex);
+    if (--(thread_pool->num_running) == 0) {
+      pthread_cond_signal(&thread_pool->job_done);
+    }
+  }
+  pthread_mutex_unlock(&thread_pool->mutex);
+  return NULL;
+}
+/*
+ * Setup
+ */
+thread_pool_t* thread_pool_new(
+    const int num_threads) {
+  // Allocate
+  thread_pool_t* const thread_pool = malloc(sizeof(thread_pool_t));
+  thread_pool->num_threads = MAX(num_threads,1);
+  thread_pool->workers = malloc(thread_pool->num_threads*sizeof(pthread_t));
+  // Current job
+  thread_pool->task = NULL;
+  thread_pool->task_args = NULL;
+  thread_pool->num_tasks = 0;
+  thread_pool->next_task = 0;
+  thread_pool->num_running = 0;
+  thread_pool->job_id = 0;
+  thread_pool->shutdown = false;
+  // Synchronization
+  pthread_mutex_init(&thread_pool->mutex,NULL);
+  pthread_cond_init(&thread_pool->job_ready,NULL);
+  pthread_cond_init(&thread_pool->job_done,NULL);
+  // Spawn workers
+  int i;
+  for (i=1;i<thread_pool->num_threads;++i) {
+    thread_pool_worker_args_t* const worker_args = malloc(sizeof(thread_pool_worker_args_t));
+    worker_args->thread_pool = thread_pool;
+    worker_args->thread_idx = i;
+    pthread_create(thread_pool->workers+i,NULL,thread_pool_worker,worker_args);
+  }
+  // Return
+  return thread_pool;
+}
+void thread_pool_delete(
+    thread_pool_t* const thread_pool) {
+  // Stop workers
+  pthread_mutex_lock(&thread_pool->mutex);
+  thread_pool->shutdown = true;
+  pthread_cond_broadcast(&thread_pool->job_ready);
+  pthread_mutex_unlock(&thread_pool->mutex);
+  int i;
+  for (i=1;i<thread_pool->num_threads;++i) {
+    pthread_join(thread_pool->workers[i],NULL);
+  }
+  // Free
+  pthread_mutex_destroy(&thread_pool->mutex);
+  pthread_cond_destroy(&thread_pool->job_ready);
+  pthread_cond_destroy(&thread_pool->job_done);
+  free(thread_pool->workers);
+  free(thread_pool);
+}
+/*
+ * Run
+ */
+void thread_pool_run(
+    thread_pool_t* const thread_pool,
+    thread_pool_task_f const task,
+    void* const task_args,
+    const int num_tasks) {
+  // Run inline (single thread or task)
+  if (thread_pool->num_threads == 1 || num_tasks <= 1) {
+    int i;
+    for (i=0;i<num_tasks;++i) task(task_args,i,0);
+    return;
+  }
+  // Publish job
+  pthread_mutex_lock(&thread_pool->mutex);
+  thread_pool->task = task;
+  thread_pool->task_args = task_args;
+  thread_pool->num_tasks = num_tasks;
+  thread_pool->next_task = 0;
+  thread_pool->num_running = thread_pool->num_threads - 1;
+  ++(thread_pool->job_id);
+  pthread_cond_broadcast(&thread_pool->job_ready);
+  pthread_mutex_unlock(&thread_pool->mutex);
+  // Run tasks (caller as thread 0)
+  thread_pool_run_tasks(thread_pool,0);
+  // Wait for workers
+  pthread_mutex_lock(&thread_pool->mutex);
+  while (thread_pool->num_running > 0) {
+    pthread_cond_wait(&thread_pool->job_done,&thread_pool->mutex);
+  }
+  pthread_mutex_unlock(&thread_pool->mutex);
+}
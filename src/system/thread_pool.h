@@ -0,0 +1,83 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignments Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignments Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: Persistent pool of worker threads running indexed tasks
+ */
+
+#ifndef THREAD_POOL_H_
+#define THREAD_POOL_H_
+
+#include "utils/commons.h"
+#include <pthread.h>
+
+/*
+ * Thread Pool
+ *   Runs num_tasks calls of a task function (task_idx in [0,num_tasks)) across the
+ *   pool and blocks until all are done. Tasks are handed out dynamically and the
+ *   calling thread takes part as thread 0 (num_threads-1 workers are spawned)
+ */
+typedef void (*thread_pool_task_f)(
+    void* const args,
+    const int task_idx,
+    const int thread_idx);
+typedef struct {
+  // Threads
+  pthread_t* workers;             // Worker threads (num_threads-1)
+  int num_threads;                // Total threads (workers plus the caller)
+  // Current job
+  thread_pool_task_f task;        // Task function
+  void* task_args;                // Task arguments
+  int num_tasks;                  // Total tasks
+  int next_task;                  // Next task to hand out (atomic)
+  int num_running;                // Workers still on the current job
+  uint64_t job_id;                // Job counter (wakes up workers)
+  bool shutdown;                  // Workers must exit
+  // Synchronization
+  pthread_mutex_t mutex;
+  pthread_cond_t job_ready;
+  pthread_cond_t job_done;
+} thread_pool_t;
+
+/*
+ * Setup
+ */
+thread_pool_t* thread_pool_new(
+    const int num_threads);
+void thread_pool_delete(
+    thread_pool_t* const thread_pool);
+
+/*
+ * Run
+ */
+void thread_pool_run(
+    thread_pool_t* const thread_pool,
+    thread_pool_task_f const task,
+    void* const task_args,
+    const int num_tasks);
+
+#endif /* THREAD_POOL_H_ */
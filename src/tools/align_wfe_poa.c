@@ -42,12 +42,13 @@
 int main(int argc,char* argv[]) {
   // Text-DAG
   text_dag_t* text_dag = text_dag_example1();
+  text_dag_topological_sort(text_dag);
   // Pattern
-  //char* pattern_buffer = "YACTGTACTY"; // (0)3M(2)2M(3)3M
-  //char* pattern_buffer = "YAGTGGAGTY"; // (0)1M1X1M(2)1M1X(3)1M1X1M
-  //char* pattern_buffer = "YACGTATY"; // (0)2M1I(2)2M(3)1M1I1M
-  //char* pattern_buffer = "YGTY"; // (0)3I(2)2M(3)3I
-  char* pattern_buffer = "YCTACGACY"; // (0)1I2M(1)2M2I1M(3)2M1I
+  //char* pattern_buffer = "YACTGTACTY"; // (1)3M(3)2M(4)3M(0)
+  //char* pattern_buffer = "YAGTGGAGTY"; // (1)1M1X1M(3)1M1X(4)1M1X1M(0)
+  //char* pattern_buffer = "YACGTATY"; // (1)2M1I(3)2M(4)1M1I1M(0)
+  //char* pattern_buffer = "YGTY"; // (1)3I(3)2M(4)3I(0)
+  char* pattern_buffer = "YCTACGACY"; // (1)1I2M(2)2M2I1M(4)2M1I(0)
   /* */
   char* pattern = pattern_buffer + 1;
   const int pattern_length = strlen(pattern_buffer) - 2;
@@ -64,8 +65,8 @@ int main(int argc,char* argv[]) {
   // Compute POA using WFE-POA
   edit_wavefront_poa_t* const wavefront_poa = edit_wavefront_poa_new(mm_allocator);
   edit_wavefront_poa_align(wavefront_poa,pattern,pattern_length,text_dag,&cigar);
-
-  text_dag_topological_sort(text_dag);
+  // Add the aligned pattern into the Text-DAG
+  text_dag_add_alignment(text_dag,pattern,pattern_length,&cigar,1+1);
 
   text_dag_traverse_heaviest_bundle(text_dag);
   for (int i = 0; i < text_dag->consensus_len; ++i) {
@@ -34,9 +34,10 @@
 /*
  * Config
  */
-#define DAG_SEGMENT_MAX_NODES   100
-#define DAG_MAX_SEGMENTS        100
-#define DAG_MAX_SEQUENCES       100
+#define DAG_SEGMENT_INIT_EDGES       2
+#define DAG_SEGMENT_INIT_SEQUENCES   4
+#define DAG_INIT_SEGMENTS           64
+#define DAG_SEQUENCES_MM_SEGMENT    BUFFER_SIZE_1M
 
 #define END_SEGMENT_ID           0
 
@@ -46,56 +47,157 @@
 text_dag_segment_t* text_dag_segment_new() {
   // Allocate
   text_dag_segment_t* const segment = malloc(sizeof(text_dag_segment_t));
-  segment->prev = malloc(DAG_SEGMENT_MAX_NODES*sizeof(int));
-  segment->prev_weight = malloc(DAG_SEGMENT_MAX_NODES*sizeof(int));
+  segment->prev = malloc(2*DAG_SEGMENT_INIT_EDGES*sizeof(int)); // Edges and weights
+  segment->prev_weight = segment->prev + DAG_SEGMENT_INIT_EDGES;
   segment->prev_total = 0;
-  segment->next = malloc(DAG_SEGMENT_MAX_NODES*sizeof(int));
+  segment->prev_allocated = DAG_SEGMENT_INIT_EDGES;
+  segment->next = malloc(DAG_SEGMENT_INIT_EDGES*sizeof(int));
   segment->next_total = 0;
-  segment->seq_rank = malloc(DAG_MAX_SEQUENCES*sizeof(int));
+  segment->next_allocated = DAG_SEGMENT_INIT_EDGES;
+  segment->seq_rank = malloc(DAG_SEGMENT_INIT_SEQUENCES*sizeof(int));
   segment->seq_rank_total = 0;
+  segment->seq_rank_allocated = DAG_SEGMENT_INIT_SEQUENCES;
   segment->sequence = NULL;
   segment->sequence_length = 0;
+  segment->sequence_packed = NULL;
   // Return
   return segment;
 }
 void text_dag_segment_delete(
     text_dag_segment_t* const segment) {
-  free(segment->sequence-1);
   free(segment->prev);
   free(segment->next);
-  free(segment->prev_weight);
   free(segment->seq_rank);
   free(segment);
 }
+void text_dag_segment_reserve_prev(
+    text_dag_segment_t* const segment,
+    const int prev_total) {
+  if (prev_total <= segment->prev_allocated) return;
+  // Grow (edges and weights share the buffer)
+  const int prev_allocated = MAX(prev_total,2*segment->prev_allocated);
+  int* const prev = malloc(2*prev_allocated*sizeof(int));
+  memcpy(prev,segment->prev,segment->prev_total*sizeof(int));
+  memcpy(prev+prev_allocated,segment->prev_weight,segment->prev_total*sizeof(int));
+  free(segment->prev);
+  segment->prev = prev;
+  segment->prev_weight = prev + prev_allocated;
+  segment->prev_allocated = prev_allocated;
+}
+void text_dag_segment_reserve_next(
+    text_dag_segment_t* const segment,
+    const int next_total) {
+  if (next_total <= segment->next_allocated) return;
+  // Grow
+  segment->next_allocated = MAX(next_total,2*segment->next_allocated);
+  segment->next = realloc(segment->next,segment->next_allocated*sizeof(int));
+}
+void text_dag_segment_reserve_seq_rank(
+    text_dag_segment_t* const segment,
+    const int seq_rank_total) {
+  if (seq_rank_total <= segment->seq_rank_allocated) return;
+  // Grow
+  segment->seq_rank_allocated = MAX(seq_rank_total,2*segment->seq_rank_allocated);
+  segment->seq_rank = realloc(segment->seq_rank,segment->seq_rank_allocated*sizeof(int));
+}
+void text_dag_segment_add_seq_rank(
+    text_dag_segment_t* const segment,
+    const int seq_rank) {
+  text_dag_segment_reserve_seq_rank(segment,segment->seq_rank_total+1);
+  segment->seq_rank[segment->seq_rank_total++] = seq_rank;
+}
+void text_dag_segment_copy_seq_rank(
+    text_dag_segment_t* const segment_dst,
+    text_dag_segment_t* const segment_src) {
+  text_dag_segment_reserve_seq_rank(segment_dst,segment_src->seq_rank_total);
+  memcpy(segment_dst->seq_rank,segment_src->seq_rank,segment_src->seq_rank_total*sizeof(int));
+  segment_dst->seq_rank_total = segment_src->seq_rank_total;
+}
 /*
  * Setup Text-DAG
  */
-text_dag_t* text_dag_new() {
+text_dag_t* text_dag_new_empty() {
   // Allocate
   text_dag_t* const text_dag = malloc(sizeof(text_dag_t));
   text_dag->num_sequences = 0;
-  text_dag->segments_ts = malloc(DAG_MAX_SEGMENTS*sizeof(text_dag_segment_t*));
-  text_dag->rank_to_segment_id = malloc(DAG_MAX_SEGMENTS*sizeof(int));
+  text_dag->segments_ts = malloc(DAG_INIT_SEGMENTS*sizeof(text_dag_segment_t*));
+  text_dag->rank_to_segment_id = malloc(DAG_INIT_SEGMENTS*sizeof(int));
+  text_dag->segment_id_to_rank = malloc(DAG_INIT_SEGMENTS*sizeof(int));
   text_dag->segments_total = 0;
-  text_dag_add_segment(text_dag,"E",'X');
-  text_dag->consensus = malloc(DAG_MAX_SEGMENTS * sizeof(int));
+  text_dag->segments_allocated = DAG_INIT_SEGMENTS;
+  text_dag->consensus = malloc(DAG_INIT_SEGMENTS * sizeof(int));
   text_dag->consensus_len = 0;
+  text_dag->reorder_marks = calloc(DAG_INIT_SEGMENTS,sizeof(int));
+  text_dag->reorder_mark = 0;
+  text_dag->reorder_buffer = malloc(3*DAG_INIT_SEGMENTS*sizeof(int));
+  text_dag->mm_sequences = mm_allocator_new(DAG_SEQUENCES_MM_SEGMENT);
+  text_dag->packed_sequences = NULL;
+  text_dag->frozen = false;
+  text_dag->frozen_segments = NULL;
+  text_dag->frozen_sequences = NULL;
+  text_dag->frozen_edges = NULL;
+  text_dag->mapped_memory = NULL;
+  text_dag->mapped_size = 0;
+  // Return
+  return text_dag;
+}
+text_dag_t* text_dag_new() {
+  // Allocate
+  text_dag_t* const text_dag = text_dag_new_empty();
+  text_dag_add_segment(text_dag,"",'X'); // END_SEGMENT_ID (empty sink)
   // Return
   return text_dag;
 }
 void text_dag_delete(
     text_dag_t* const text_dag) {
+  // Free memory-mapped Text-DAG (only the segment views are allocated)
+  if (text_dag->mapped_memory != NULL) {
+    free(text_dag->frozen_segments);
+    free(text_dag->segments_ts);
+    free(text_dag->packed_sequences);
+    munmap(text_dag->mapped_memory,text_dag->mapped_size);
+    free(text_dag);
+    return;
+  }
   // Free individual segments
-  int i;
-  for (i=0;i<text_dag->segments_total;++i) {
-    text_dag_segment_delete(text_dag->segments_ts[i]);
+  if (text_dag->frozen) {
+    free(text_dag->frozen_segments);
+    free(text_dag->frozen_sequences);
+    free(text_dag->frozen_edges);
+  } else {
+    int i;
+    for (i=0;i<text_dag->segments_total;++i) {
+      text_dag_segment_delete(text_dag->segments_ts[i]);
+    }
+    mm_allocator_delete(text_dag->mm_sequences);
   }
   // Free DAG
   free(text_dag->segments_ts);
   free(text_dag->rank_to_segment_id);
+  free(text_dag->segment_id_to_rank);
   free(text_dag->consensus);
+  free(text_dag->reorder_marks);
+  free(text_dag->reorder_buffer);
+  free(text_dag->packed_sequences);
   free(text_dag);
 }
+void text_dag_reserve(
+    text_dag_t* const text_dag,
+    const int segments_total) {
+  if (segments_total <= text_dag->segments_allocated) return;
+  // Grow
+  const int segments_allocated = MAX(segments_total,2*text_dag->segments_allocated);
+  text_dag->segments_ts = realloc(text_dag->segments_ts,segments_allocated*sizeof(text_dag_segment_t*));
+  text_dag->rank_to_segment_id = realloc(text_dag->rank_to_segment_id,segments_allocated*sizeof(int));
+  text_dag->segment_id_to_rank = realloc(text_dag->segment_id_to_rank,segments_allocated*sizeof(int));
+  text_dag->consensus = realloc(text_dag->consensus,segments_allocated*sizeof(int));
+  text_dag->reorder_marks = realloc(text_dag->reorder_marks,segments_allocated*sizeof(int));
+  memset(text_dag->reorder_marks+text_dag->segments_allocated,0,
+      (segments_allocated-text_dag->segments_allocated)*sizeof(int));
+  free(text_dag->reorder_buffer); // Temporary (no need to preserve)
+  text_dag->reorder_buffer = malloc(3*segments_allocated*sizeof(int));
+  text_dag->segments_allocated = segments_allocated;
+}
 /*
  * Accessors
  */
@@ -103,21 +205,36 @@ void text_dag_add_segment(
     text_dag_t* const text_dag,
     char* const sequence,
     const char sentinel) {
+  text_dag_add_segment_length(text_dag,sequence,strlen(sequence),sentinel);
+}
+void text_dag_add_segment_length(
+    text_dag_t* const text_dag,
+    const char* const sequence,
+    const int sequence_length,
+    const char sentinel) {
+  // Check mutable
+  if (text_dag->frozen) {
+    fprintf(stderr,"[wfpoa::text_dag_add_segment] error: text-DAG is frozen\n");
+    exit(1);
+  }
   // Create new segment
   text_dag_segment_t* const segment = text_dag_segment_new();
-  // Allocate and copy padded sequence
-  const int sequence_length = strlen(sequence);
-  char* const sequence_buffer = malloc(sequence_length+3);
+  // Allocate and copy padded sequence (from the sequences arena)
+  char* const sequence_buffer = mm_allocator_malloc(text_dag->mm_sequences,sequence_length+3);
   sequence_buffer[0] = sentinel;
-  strncpy(sequence_buffer+1,sequence,sequence_length);
+  memcpy(sequence_buffer+1,sequence,sequence_length);
   sequence_buffer[sequence_length+1] = sentinel;
   sequence_buffer[sequence_length+2] = '\0';
   segment->sequence = sequence_buffer + 1;
   segment->sequence_length = sequence_length;
-  // Insert new segment
-  text_dag->segments_ts[text_dag->segments_total++] = segment;
+  // Insert new segment (last in the topological order)
+  text_dag_reserve(text_dag,text_dag->segments_total+1);
+  const int segment_id = text_dag->segments_total++;
+  text_dag->segments_ts[segment_id] = segment;
+  text_dag->rank_to_segment_id[segment_id] = segment_id;
+  text_dag->segment_id_to_rank[segment_id] = segment_id;
 }
-void text_dag_add_connection(
+void text_dag_add_edge(
     text_dag_t* const text_dag,
     const int segment_id_a,
     const int segment_id_b,
@@ -125,26 +242,99 @@ void text_dag_add_connection(
   // Parameters
   text_dag_segment_t* const segment_a = text_dag->segments_ts[segment_id_a];
   text_dag_segment_t* const segment_b = text_dag->segments_ts[segment_id_b];
-
-  // Add sequence
-  segment_a->seq_rank[segment_a->seq_rank_total++] = text_dag->num_sequences;
-
-  // Connect segments
+  // Check mutable
+  if (text_dag->frozen) {
+    fprintf(stderr,"[wfpoa::text_dag_add_edge] error: text-DAG is frozen\n");
+    exit(1);
+  }
   // Check if the connection already exists
-  for (int i = 0; i < segment_b->prev_total; ++i) {
-      if (segment_b->prev[i] == segment_id_a) {
-          // Increment weight
-          segment_b->prev_weight[i] += weight;
-          return;
-      }
+  int i;
+  for (i=0;i<segment_b->prev_total;++i) {
+    if (segment_b->prev[i] == segment_id_a) {
+      segment_b->prev_weight[i] += weight; // Increment weight
+      return;
+    }
   }
-
   // New connection
+  text_dag_segment_reserve_next(segment_a,segment_a->next_total+1);
+  text_dag_segment_reserve_prev(segment_b,segment_b->prev_total+1);
   segment_a->next[segment_a->next_total++] = segment_id_b;
   segment_b->prev[segment_b->prev_total] = segment_id_a;
   segment_b->prev_weight[segment_b->prev_total++] = weight;
 }
+void text_dag_add_connection(
+    text_dag_t* const text_dag,
+    const int segment_id_a,
+    const int segment_id_b,
+    const int weight) {
+  // Parameters
+  text_dag_segment_t* const segment_a = text_dag->segments_ts[segment_id_a];
+
+  // Add sequence
+  text_dag_segment_add_seq_rank(segment_a,text_dag->num_sequences);
 
+  // Connect segments
+  text_dag_add_edge(text_dag,segment_id_a,segment_id_b,weight);
+
+  // Restore the topological order (if broken)
+  if (text_dag->segment_id_to_rank[segment_id_a] > text_dag->segment_id_to_rank[segment_id_b]) {
+    text_dag_reorder(text_dag,segment_id_a,segment_id_b);
+  }
+}
+int text_dag_segment_weight(
+    text_dag_t* const text_dag,
+    const int segment_id) {
+  // Parameters
+  text_dag_segment_t* const segment = text_dag->segments_ts[segment_id];
+  int weight = 0, i, j;
+  // Ingoing weights
+  for (i=0;i<segment->prev_total;++i) weight += segment->prev_weight[i];
+  if (segment->prev_total > 0) return weight;
+  // Outgoing weights (source segment)
+  for (i=0;i<segment->next_total;++i) {
+    text_dag_segment_t* const segment_next = text_dag->segments_ts[segment->next[i]];
+    for (j=0;j<segment_next->prev_total;++j) {
+      if (segment_next->prev[j] == segment_id) weight += segment_next->prev_weight[j];
+    }
+  }
+  return weight;
+}
+int text_dag_split_segment(
+    text_dag_t* const text_dag,
+    const int segment_id,
+    const int offset) {
+  // Parameters
+  const int weight = text_dag_segment_weight(text_dag,segment_id);
+  const char sentinel = text_dag->segments_ts[segment_id]->sequence[-1];
+  int i, j;
+  // Add suffix segment
+  text_dag_segment_t* const segment = text_dag->segments_ts[segment_id];
+  const int suffix_length = segment->sequence_length - offset;
+  text_dag_add_segment_length(text_dag,segment->sequence+offset,suffix_length,sentinel);
+  const int split_id = text_dag->segments_total - 1;
+  text_dag_segment_t* const split = text_dag->segments_ts[split_id];
+  // Move outgoing edges to the suffix
+  text_dag_segment_reserve_next(split,segment->next_total);
+  for (i=0;i<segment->next_total;++i) {
+    text_dag_segment_t* const segment_next = text_dag->segments_ts[segment->next[i]];
+    for (j=0;j<segment_next->prev_total;++j) {
+      if (segment_next->prev[j] == segment_id) segment_next->prev[j] = split_id;
+    }
+    split->next[i] = segment->next[i];
+  }
+  split->next_total = segment->next_total;
+  segment->next_total = 0;
+  // Sequences traversing the segment traverse the suffix
+  text_dag_segment_copy_seq_rank(split,segment);
+  // Truncate to the prefix (keeping the padding)
+  segment->sequence[offset] = sentinel;
+  segment->sequence[offset+1] = '\0';
+  segment->sequence_length = offset;
+  // Connect prefix and suffix
+  text_dag_add_edge(text_dag,segment_id,split_id,weight);
+  // Return
+  return split_id;
+}
 void text_dag_topological_sort(
         text_dag_t* const text_dag){
     // Clear ranks
@@ -175,6 +365,7 @@ void text_dag_topological_sort(
         int segment_id = segment_ids_to_visit[--stack_next_index]; //top();
         text_dag_segment_t* segment = text_dag->segments_ts[segment_id];
 
+        text_dag->segment_id_to_rank[segment_id] = segment_rank;
         text_dag->rank_to_segment_id[segment_rank++] = segment_id;
 
         for (int j = 0; j < segment->next_total; ++j) {
@@ -204,6 +395,514 @@ void text_dag_topological_sort(
 //    }
 }
 
+int text_dag_reorder_mark(
+    text_dag_t* const text_dag) {
+  // Restart the marks before the counter overflows
+  if (text_dag->reorder_mark == INT_MAX) {
+    memset(text_dag->reorder_marks,0,text_dag->segments_allocated*sizeof(int));
+    text_dag->reorder_mark = 0;
+  }
+  return ++(text_dag->reorder_mark);
+}
+void text_dag_reorder(
+    text_dag_t* const text_dag,
+    const int segment_id_a,
+    const int segment_id_b) {
+  // Parameters
+  int* const segment_id_to_rank = text_dag->segment_id_to_rank;
+  int* const rank_to_segment_id = text_dag->rank_to_segment_id;
+  int* const marks = text_dag->reorder_marks;
+  const int rank_lo = segment_id_to_rank[segment_id_b];
+  const int rank_hi = segment_id_to_rank[segment_id_a];
+  int* const stack = text_dag->reorder_buffer;
+  int* const forward = text_dag->reorder_buffer + text_dag->segments_allocated;
+  int* const ranks = text_dag->reorder_buffer + 2*text_dag->segments_allocated;
+  int* const backward = stack; // Reused once the searches are done
+  int i, rank, stack_total = 0;
+  // Mark the segments reachable from segment-b (ranked before segment-a)
+  const int mark_forward = text_dag_reorder_mark(text_dag);
+  marks[segment_id_b] = mark_forward;
+  stack[stack_total++] = segment_id_b;
+  while (stack_total > 0) {
+    text_dag_segment_t* const segment = text_dag->segments_ts[stack[--stack_total]];
+    for (i=0;i<segment->next_total;++i) {
+      const int segment_id_next = segment->next[i];
+      assert(segment_id_next != segment_id_a &&
+          "[wfpoa::text_dag_reorder] error: graph is not a DAG");
+      if (marks[segment_id_next] == mark_forward) continue;
+      if (segment_id_to_rank[segment_id_next] > rank_hi) continue;
+      marks[segment_id_next] = mark_forward;
+      stack[stack_total++] = segment_id_next;
+    }
+  }
+  // Mark the segments reaching segment-a (ranked after segment-b)
+  const int mark_backward = text_dag_reorder_mark(text_dag);
+  marks[segment_id_a] = mark_backward;
+  stack[stack_total++] = segment_id_a;
+  while (stack_total > 0) {
+    text_dag_segment_t* const segment = text_dag->segments_ts[stack[--stack_total]];
+    for (i=0;i<segment->prev_total;++i) {
+      const int segment_id_prev = segment->prev[i];
+      if (marks[segment_id_prev] == mark_backward) continue;
+      if (segment_id_to_rank[segment_id_prev] < rank_lo) continue;
+      marks[segment_id_prev] = mark_backward;
+      stack[stack_total++] = segment_id_prev;
+    }
+  }
+  // Collect the affected segments (in topological order) and their ranks
+  int forward_total = 0, backward_total = 0, ranks_total = 0;
+  for (rank=rank_lo;rank<=rank_hi;++rank) {
+    const int segment_id = rank_to_segment_id[rank];
+    if (marks[segment_id] == mark_backward) {
+      backward[backward_total++] = segment_id;
+    } else if (marks[segment_id] == mark_forward) {
+      forward[forward_total++] = segment_id;
+    } else {
+      continue;
+    }
+    ranks[ranks_total++] = rank;
+  }
+  // Re-rank (segments reaching segment-a before those reachable from segment-b)
+  for (i=0;i<backward_total;++i) {
+    rank_to_segment_id[ranks[i]] = backward[i];
+    segment_id_to_rank[backward[i]] = ranks[i];
+  }
+  for (i=0;i<forward_total;++i) {
+    rank = ranks[backward_total+i];
+    rank_to_segment_id[rank] = forward[i];
+    segment_id_to_rank[forward[i]] = rank;
+  }
+}
+void text_dag_sort_window(
+    text_dag_t* const text_dag,
+    int rank_begin,
+    int rank_end,
+    const int segment_new_begin) {
+  // Parameters
+  int* const segment_id_to_rank = text_dag->segment_id_to_rank;
+  int* const rank_to_segment_id = text_dag->rank_to_segment_id;
+  int* const marks = text_dag->reorder_marks;
+  const int segments_total = text_dag->segments_total;
+  const int segments_new = segments_total - segment_new_begin;
+  int* const in_degree = text_dag->reorder_buffer;
+  int* const stack = text_dag->reorder_buffer + text_dag->segments_allocated;
+  int* const window = text_dag->reorder_buffer + 2*text_dag->segments_allocated;
+  int i, j, rank, window_total = 0, stack_total = 0;
+  if (rank_begin > rank_end) { // Empty window (new segments go last)
+    rank_begin = segment_new_begin;
+    rank_end = segment_new_begin - 1;
+  }
+  // Mark the segments of the window (old within the ranks and all new ones)
+  const int mark = text_dag_reorder_mark(text_dag);
+  for (rank=rank_begin;rank<=rank_end;++rank) {
+    window[window_total++] = rank_to_segment_id[rank];
+  }
+  for (i=segment_new_begin;i<segments_total;++i) window[window_total++] = i;
+  for (i=0;i<window_total;++i) marks[window[i]] = mark;
+  // Compute in-degrees within the window
+  for (i=0;i<window_total;++i) {
+    text_dag_segment_t* const segment = text_dag->segments_ts[window[i]];
+    in_degree[window[i]] = 0;
+    for (j=0;j<segment->prev_total;++j) {
+      if (marks[segment->prev[j]] == mark) ++in_degree[window[i]];
+    }
+  }
+  for (i=window_total-1;i>=0;--i) {
+    if (in_degree[window[i]] == 0) stack[stack_total++] = window[i];
+  }
+  // Shift the ranks after the window
+  for (rank=segment_new_begin-1;rank>rank_end;--rank) {
+    const int segment_id = rank_to_segment_id[rank];
+    rank_to_segment_id[rank+segments_new] = segment_id;
+    segment_id_to_rank[segment_id] = rank+segments_new;
+  }
+  // Sort the window (Kahn's algorithm)
+  rank = rank_begin;
+  while (stack_total > 0) {
+    const int segment_id = stack[--stack_total];
+    text_dag_segment_t* const segment = text_dag->segments_ts[segment_id];
+    segment_id_to_rank[segment_id] = rank;
+    rank_to_segment_id[rank++] = segment_id;
+    for (j=0;j<segment->next_total;++j) {
+      const int segment_id_next = segment->next[j];
+      if (marks[segment_id_next] != mark) continue;
+      if (--in_degree[segment_id_next] == 0) stack[stack_total++] = segment_id_next;
+    }
+  }
+  // Check if there was a cycle
+  assert(
+      (rank == rank_begin + window_total) &&
+      "[wfpoa::text_dag_sort_window] error: graph is not a DAG");
+}
+
+/*
+ * Progressive POA
+ */
+int text_dag_add_pattern_segment(
+    text_dag_t* const text_dag,
+    char* const pattern,
+    const int pattern_begin,
+    const int pattern_end) {
+  // Add segment (pattern stretch)
+  text_dag_add_segment_length(text_dag,pattern+pattern_begin,pattern_end-pattern_begin,'X');
+  return text_dag->segments_total - 1;
+}
+void text_dag_add_alignment(
+    text_dag_t* const text_dag,
+    char* const pattern,
+    const int pattern_length,
+    cigar_t* const cigar,
+    const int weight) {
+  // Parameters
+  char* const operations = cigar->operations;
+  const int begin_offset = cigar->begin_offset;
+  const int end_offset = cigar->end_offset;
+  const int num_operations = end_offset - begin_offset;
+  const int segments_total = text_dag->segments_total;
+  const int segment_source = text_dag->rank_to_segment_id[0];
+  int segment_sink = text_dag->rank_to_segment_id[segments_total-1];
+  int rank_begin = segments_total, rank_end = -1; // Ranks spanned by the alignment
+  int i, j, v = 0;
+  // Allocate
+  int* const path_buffer = malloc((num_operations+3)*sizeof(int));
+  int* const pieces_offset = malloc((num_operations+1)*sizeof(int));
+  int* const pieces_id = malloc((num_operations+1)*sizeof(int));
+  int* path = path_buffer + 1; // Segments traversed (room for the source/sink)
+  int path_length = 0;
+  bool path_from_source = false, path_to_sink = false;
+  // Traverse the segments of the alignment
+  i = begin_offset;
+  while (i < end_offset) {
+    // Fetch segment
+    if (operations[i] != CIGAR_OP_SEGMENT) {
+      fprintf(stderr,"[wfpoa::text_dag_add_alignment] error: operations outside a segment\n");
+      exit(1);
+    }
+    const int segment_id = cigar->segment_ids[i++];
+    if (i-1 == begin_offset) path_from_source = (segment_id == segment_source);
+    path_to_sink = (segment_id == segment_sink);
+    rank_begin = MIN(rank_begin,text_dag->segment_id_to_rank[segment_id]);
+    rank_end = MAX(rank_end,text_dag->segment_id_to_rank[segment_id]);
+    const int sequence_length = text_dag->segments_ts[segment_id]->sequence_length;
+    // Cut the segment at the boundaries between matching and differing runs
+    const int segment_begin = i;
+    int num_pieces = 1, h = 0;
+    pieces_offset[0] = 0;
+    pieces_id[0] = segment_id;
+    for (;i<end_offset && operations[i]!=CIGAR_OP_SEGMENT;++i) {
+      const char operation = operations[i];
+      if (i > segment_begin && (operation=='M') != (operations[i-1]=='M') &&
+          0 < h && h < sequence_length && h != pieces_offset[num_pieces-1]) {
+        pieces_offset[num_pieces++] = h;
+      }
+      h += (operation=='M' || operation=='X' || operation=='I');
+    }
+    if (h != sequence_length) {
+      fprintf(stderr,"[wfpoa::text_dag_add_alignment] error: segment %d not fully aligned\n",segment_id);
+      exit(1);
+    }
+    for (j=1;j<num_pieces;++j) {
+      pieces_id[j] = text_dag_split_segment(text_dag,
+          pieces_id[j-1],pieces_offset[j]-pieces_offset[j-1]);
+    }
+    if (segment_id == segment_sink) segment_sink = pieces_id[num_pieces-1];
+    // Add the runs to the path (matches reuse the pieces, differences add the pattern stretch)
+    if (i == segment_begin) path[path_length++] = segment_id; // Empty segment
+    int piece = 0;
+    h = 0;
+    j = segment_begin;
+    while (j < i) {
+      const bool match = (operations[j]=='M');
+      const int h_begin = h, v_begin = v;
+      for (;j<i && (operations[j]=='M')==match;++j) {
+        const char operation = operations[j];
+        h += (operation=='M' || operation=='X' || operation=='I');
+        v += (operation=='M' || operation=='X' || operation=='D');
+      }
+      if (match) {
+        while (pieces_offset[piece] != h_begin) ++piece;
+        path[path_length++] = pieces_id[piece];
+      } else if (v > v_begin) {
+        path[path_length++] = text_dag_add_pattern_segment(text_dag,pattern,v_begin,v);
+      }
+    }
+  }
+  if (path_length == 0 || v != pattern_length) {
+    fprintf(stderr,"[wfpoa::text_dag_add_alignment] error: pattern not fully aligned\n");
+    exit(1);
+  }
+  // Keep a single source (the pattern may diverge at the very beginning)
+  const int path_first = path[0];
+  if (path_first != segment_source &&
+      (path_from_source || text_dag->segments_ts[path_first]->prev_total == 0)) {
+    int source = segment_source;
+    if (text_dag->segments_ts[segment_source]->sequence_length > 0) {
+      text_dag_add_segment(text_dag,"",'X'); // Empty source (traversed by every sequence)
+      source = text_dag->segments_total - 1;
+      text_dag_segment_t* const segment = text_dag->segments_ts[segment_source];
+      text_dag_segment_t* const segment_empty = text_dag->segments_ts[source];
+      text_dag_segment_copy_seq_rank(segment_empty,segment);
+      text_dag_add_edge(text_dag,source,segment_source,
+          text_dag_segment_weight(text_dag,segment_source));
+    }
+    *(--path) = source;
+    ++path_length;
+    rank_begin = 0;
+  }
+  // Keep a single sink (the pattern may diverge at the very end)
+  const int path_last = path[path_length-1];
+  if (path_last != segment_sink &&
+      (path_to_sink || text_dag->segments_ts[path_last]->next_total == 0)) {
+    int sink = segment_sink;
+    if (text_dag->segments_ts[segment_sink]->sequence_length > 0) {
+      text_dag_add_segment(text_dag,"",'X'); // Empty sink
+      sink = text_dag->segments_total - 1;
+      text_dag_add_edge(text_dag,segment_sink,sink,
+          text_dag_segment_weight(text_dag,segment_sink));
+    }
+    path[path_length++] = sink;
+    rank_end = segments_total - 1;
+  }
+  // Connect the path
+  for (i=1;i<path_length;++i) {
+    text_dag_segment_t* const segment = text_dag->segments_ts[path[i-1]];
+    text_dag_segment_add_seq_rank(segment,text_dag->num_sequences);
+    text_dag_add_edge(text_dag,path[i-1],path[i],weight);
+  }
+  ++(text_dag->num_sequences);
+  // Free
+  free(path_buffer);
+  free(pieces_offset);
+  free(pieces_id);
+  // Sort the new segments within the ranks spanned by the alignment
+  text_dag_sort_window(text_dag,rank_begin,rank_end,segments_total);
+}
+/*
+ * Derived Text-DAGs (require the Text-DAG to be topologically sorted)
+ */
+text_dag_t* text_dag_reverse(
+    text_dag_t* const text_dag) {
+  // Parameters
+  const int segments_total = text_dag->segments_total;
+  int i, j;
+  // Allocate
+  text_dag_t* const text_dag_reversed = text_dag_new_empty();
+  // Add reversed segments (same segment ids)
+  for (i=0;i<segments_total;++i) {
+    text_dag_segment_t* const segment = text_dag->segments_ts[i];
+    const int sequence_length = segment->sequence_length;
+    text_dag_add_segment_length(text_dag_reversed,segment->sequence,sequence_length,'X');
+    char* const sequence_reversed = text_dag_reversed->segments_ts[i]->sequence;
+    for (j=0;j<sequence_length/2;++j) {
+      const char base = sequence_reversed[j];
+      sequence_reversed[j] = sequence_reversed[sequence_length-1-j];
+      sequence_reversed[sequence_length-1-j] = base;
+    }
+  }
+  // Reversed topological order (set first, so connections need no reordering)
+  for (i=0;i<segments_total;++i) {
+    const int segment_id = text_dag->rank_to_segment_id[segments_total-1-i];
+    text_dag_reversed->rank_to_segment_id[i] = segment_id;
+    text_dag_reversed->segment_id_to_rank[segment_id] = i;
+  }
+  // Add reversed connections
+  for (i=0;i<segments_total;++i) {
+    text_dag_segment_t* const segment = text_dag->segments_ts[i];
+    for (j=0;j<segment->prev_total;++j) {
+      text_dag_add_connection(text_dag_reversed,i,segment->prev[j],segment->prev_weight[j]);
+    }
+  }
+  // Return
+  return text_dag_reversed;
+}
+text_dag_t* text_dag_subgraph(
+    text_dag_t* const text_dag,
+    const int segment_begin,
+    const int offset_begin,
+    const int segment_end,
+    const int offset_end,
+    int* const segment_ids) {
+  // Parameters
+  const int segments_total = text_dag->segments_total;
+  const int rank_begin = text_dag->segment_id_to_rank[segment_begin];
+  const int rank_end = text_dag->segment_id_to_rank[segment_end];
+  int i, j, rank;
+  // Mark segments reachable from segment-begin
+  bool* const reach_begin = calloc(segments_total,sizeof(bool));
+  reach_begin[segment_begin] = true;
+  for (rank=rank_begin;rank<=rank_end;++rank) {
+    const int segment_id = text_dag->rank_to_segment_id[rank];
+    if (!reach_begin[segment_id]) continue;
+    text_dag_segment_t* const segment = text_dag->segments_ts[segment_id];
+    for (j=0;j<segment->next_total;++j) reach_begin[segment->next[j]] = true;
+  }
+  // Mark segments reaching segment-end (only those reachable from segment-begin)
+  bool* const reach_end = calloc(segments_total,sizeof(bool));
+  reach_end[segment_end] = true;
+  for (rank=rank_end;rank>=rank_begin;--rank) {
+    const int segment_id = text_dag->rank_to_segment_id[rank];
+    if (!reach_end[segment_id]) continue;
+    text_dag_segment_t* const segment = text_dag->segments_ts[segment_id];
+    for (j=0;j<segment->prev_total;++j) reach_end[segment->prev[j]] = true;
+  }
+  // Add segments in between (topologically sorted)
+  text_dag_t* const subgraph = text_dag_new_empty();
+  int* const subgraph_ids = malloc(segments_total*sizeof(int));
+  for (rank=rank_begin;rank<=rank_end;++rank) {
+    const int segment_id = text_dag->rank_to_segment_id[rank];
+    if (!reach_begin[segment_id] || !reach_end[segment_id]) continue;
+    text_dag_segment_t* const segment = text_dag->segments_ts[segment_id];
+    // Trim sequence (first and last segments)
+    const int offset_from = (segment_id==segment_begin) ? offset_begin : 0;
+    const int offset_to = (segment_id==segment_end) ? offset_end : segment->sequence_length;
+    // Add segment
+    subgraph_ids[segment_id] = subgraph->segments_total;
+    segment_ids[subgraph->segments_total] = segment_id;
+    text_dag_add_segment_length(subgraph,
+        segment->sequence+offset_from,offset_to-offset_from,'X');
+  }
+  // Add connections in between
+  for (i=0;i<subgraph->segments_total;++i) {
+    const int segment_id = segment_ids[i];
+    if (segment_id == segment_end) continue;
+    text_dag_segment_t* const segment = text_dag->segments_ts[segment_id];
+    for (j=0;j<segment->next_total;++j) {
+      const int next_id = segment->next[j];
+      if (!reach_begin[next_id] || !reach_end[next_id]) continue;
+      text_dag_add_connection(subgraph,i,subgraph_ids[next_id],1);
+    }
+  }
+  // Free
+  free(reach_begin);
+  free(reach_end);
+  free(subgraph_ids);
+  // Return
+  return subgraph;
+}
+
+/*
+ * Frozen Text-DAG
+ */
+text_dag_t* text_dag_freeze(
+    text_dag_t* const text_dag) {
+  // Parameters
+  const int segments_total = text_dag->segments_total;
+  uint64_t sequences_length = 0, edges_total = 0;
+  int i, rank;
+  for (i=0;i<segments_total;++i) {
+    text_dag_segment_t* const segment = text_dag->segments_ts[i];
+    sequences_length += segment->sequence_length + 3; // Padded and terminated
+    edges_total += segment->next_total + 2*segment->prev_total;
+  }
+  // Allocate
+  text_dag_t* const text_dag_frozen = malloc(sizeof(text_dag_t));
+  text_dag_frozen->num_sequences = text_dag->num_sequences;
+  text_dag_frozen->segments_ts = malloc(segments_total*sizeof(text_dag_segment_t*));
+  text_dag_frozen->rank_to_segment_id = malloc(segments_total*sizeof(int));
+  text_dag_frozen->segment_id_to_rank = malloc(segments_total*sizeof(int));
+  text_dag_frozen->segments_total = segments_total;
+  text_dag_frozen->segments_allocated = segments_total;
+  text_dag_frozen->consensus = NULL;
+  text_dag_frozen->consensus_len = 0;
+  text_dag_frozen->reorder_marks = NULL;
+  text_dag_frozen->reorder_mark = 0;
+  text_dag_frozen->reorder_buffer = NULL;
+  text_dag_frozen->mm_sequences = NULL;
+  text_dag_frozen->packed_sequences = NULL;
+  text_dag_frozen->frozen = true;
+  text_dag_frozen->frozen_segments = malloc(segments_total*sizeof(text_dag_segment_t));
+  text_dag_frozen->frozen_sequences = malloc(sequences_length);
+  text_dag_frozen->frozen_edges = malloc(edges_total*sizeof(int));
+  text_dag_frozen->mapped_memory = NULL;
+  text_dag_frozen->mapped_size = 0;
+  memcpy(text_dag_frozen->rank_to_segment_id,text_dag->rank_to_segment_id,segments_total*sizeof(int));
+  memcpy(text_dag_frozen->segment_id_to_rank,text_dag->segment_id_to_rank,segments_total*sizeof(int));
+  // Pack the segments in topological order (keeping their ids)
+  char* sequences = text_dag_frozen->frozen_sequences;
+  int* edges = text_dag_frozen->frozen_edges;
+  for (rank=0;rank<segments_total;++rank) {
+    const int segment_id = text_dag->rank_to_segment_id[rank];
+    text_dag_segment_t* const segment = text_dag->segments_ts[segment_id];
+    text_dag_segment_t* const segment_frozen = text_dag_frozen->frozen_segments + rank;
+    // Sequence (with its padding)
+    const int sequence_length = segment->sequence_length;
+    memcpy(sequences,segment->sequence-1,sequence_length+3);
+    segment_frozen->sequence = sequences + 1;
+    segment_frozen->sequence_length = sequence_length;
+    segment_frozen->sequence_packed = NULL;
+    sequences += sequence_length + 3;
+    // Links
+    segment_frozen->next = edges;
+    segment_frozen->next_total = segment->next_total;
+    segment_frozen->next_allocated = segment->next_total;
+    memcpy(edges,segment->next,segment->next_total*sizeof(int));
+    edges += segment->next_total;
+    segment_frozen->prev = edges;
+    segment_frozen->prev_total = segment->prev_total;
+    segment_frozen->prev_allocated = segment->prev_total;
+    memcpy(edges,segment->prev,segment->prev_total*sizeof(int));
+    edges += segment->prev_total;
+    segment_frozen->prev_weight = edges;
+    memcpy(edges,segment->prev_weight,segment->prev_total*sizeof(int));
+    edges += segment->prev_total;
+    // Sequence ranks (not kept)
+    segment_frozen->seq_rank = NULL;
+    segment_frozen->seq_rank_total = 0;
+    segment_frozen->seq_rank_allocated = 0;
+    text_dag_frozen->segments_ts[segment_id] = segment_frozen;
+  }
+  // Packed sequences (if packed)
+  if (text_dag->packed_sequences != NULL) text_dag_pack(text_dag_frozen);
+  // Return
+  return text_dag_frozen;
+}
+
+/*
+ * 2-bit packed sequences
+ */
+bool text_dag_sequence_pack(
+    const char* const sequence,
+    const int sequence_length,
+    uint64_t* const sequence_packed) {
+  // Clear (including the padding word)
+  const int num_words = TEXT_DAG_PACKED_WORDS(sequence_length);
+  memset(sequence_packed,0,num_words*sizeof(uint64_t));
+  // Pack (A=0, C=1, G=2, T=3)
+  int i;
+  for (i=0;i<sequence_length;++i) {
+    uint64_t code;
+    switch (sequence[i]) {
+      case 'A': code = 0; break;
+      case 'C': code = 1; break;
+      case 'G': code = 2; break;
+      case 'T': code = 3; break;
+      default: return false; // Not packable
+    }
+    sequence_packed[i>>5] |= code << ((i&31)<<1);
+  }
+  return true;
+}
+void text_dag_pack(
+    text_dag_t* const text_dag) {
+  // Parameters
+  const int segments_total = text_dag->segments_total;
+  int i, num_words = 0;
+  for (i=0;i<segments_total;++i) {
+    num_words += TEXT_DAG_PACKED_WORDS(text_dag->segments_ts[i]->sequence_length);
+  }
+  // Allocate (replacing any previous packing)
+  free(text_dag->packed_sequences);
+  text_dag->packed_sequences = malloc(num_words*sizeof(uint64_t));
+  // Pack segments (keeping unpackable ones as plain sequences)
+  uint64_t* packed = text_dag->packed_sequences;
+  for (i=0;i<segments_total;++i) {
+    text_dag_segment_t* const segment = text_dag->segments_ts[i];
+    const bool packable = text_dag_sequence_pack(segment->sequence,segment->sequence_length,packed);
+    segment->sequence_packed = (packable) ? packed : NULL;
+    packed += TEXT_DAG_PACKED_WORDS(segment->sequence_length);
+  }
+}
+
 int text_dag_branch_completion(
         text_dag_t* const text_dag,
         int64_t *scores,
@@ -278,6 +977,11 @@ void text_dag_traverse_heaviest_bundle(
     int segment_id;
     text_dag_segment_t* segment;
 
+    if (text_dag->frozen) {
+        fprintf(stderr,"[wfpoa::text_dag_traverse_heaviest_bundle] error: text-DAG is frozen\n");
+        exit(1);
+    }
+
     int64_t *predecessors = malloc(text_dag->segments_total * sizeof(int64_t));
     int64_t *scores = malloc(text_dag->segments_total * sizeof(int64_t));
     for (i = 0; i < text_dag->segments_total; i++) {
@@ -312,19 +1016,11 @@ void text_dag_traverse_heaviest_bundle(
     }
 
     if (text_dag->segments_ts[segment_id_with_max_score]->next_total > 0) {
-        int* segment_id_to_rank = malloc(text_dag->segments_total * sizeof(int));
-
-        for (i = 0; i < text_dag->segments_total; ++i) {
-            segment_id_to_rank[text_dag->rank_to_segment_id[i]] = i;
-        }
-
         do {
             segment_id_with_max_score = text_dag_branch_completion(text_dag,
                                                                    scores, predecessors,
-                                                                   segment_id_to_rank[segment_id_with_max_score]);
+                                                                   text_dag->segment_id_to_rank[segment_id_with_max_score]);
         } while (text_dag->segments_ts[segment_id_with_max_score]->next_total != 0);
-
-        free(segment_id_to_rank);
     }
 
     // Traceback
@@ -363,10 +1059,18 @@ void text_dag_generate_gfa(
         }
     }
 
+    // Read paths (sized by the number of segments traversed by each read)
     int* read_path_i = (int*)calloc(text_dag->num_sequences, sizeof(int));
+    for (i = 0; i < text_dag->segments_total; ++i) {
+        text_dag_segment_t* segment = text_dag->segments_ts[i];
+        for (j = 0; j < segment->seq_rank_total; ++j) {
+            ++read_path_i[segment->seq_rank[j]];
+        }
+    }
     int** read_paths = (int**)malloc(text_dag->num_sequences * sizeof(int*));
     for (i = 0; i < text_dag->num_sequences; ++i) {
-        read_paths[i] = (int*)malloc(text_dag->segments_total * sizeof(int));
+        read_paths[i] = (int*)malloc(read_path_i[i] * sizeof(int));
+        read_path_i[i] = 0;
     }
 
     // Output header
@@ -33,38 +33,84 @@
 #define TEXT_DAG_H_
 
 #include "commons.h"
+#include "system/mm_allocator.h"
+#include "alignment/cigar.h"
 
 /*
  * Text DAG (Topologically sorted)
  */
 typedef struct {
   // Sequence
-  char* sequence;
+  char* sequence;                   // Padded with sentinels (allocated in the sequences arena)
   int sequence_length;
+  uint64_t* sequence_packed;        // 2-bit packed sequence (NULL if not packed)
   // Links
   int* prev;                        // Ingoing edges
   int prev_total;
-  int* prev_weight;                 // Weight of the ingoing edges
+  int prev_allocated;
+  int* prev_weight;                 // Weight of the ingoing edges (same buffer as prev)
   int* next;                        // Outgoing edges
   int next_total;
+  int next_allocated;
   int* seq_rank;                    // Ranks of the sequences (wrt the order in which they are aligned)
   int seq_rank_total;
+  int seq_rank_allocated;
 } text_dag_segment_t;
 typedef struct {
   int num_sequences;
   text_dag_segment_t** segments_ts; // Topologically Sorted (todo use rank_to_segment_id)
   int* rank_to_segment_id;          // From ranks (topological sorted) to segment ids
+  int* segment_id_to_rank;          // From segment ids to ranks (topological sorted)
   int segments_total;               // Total number of segments
+  int segments_allocated;           // Capacity of the per-segment arrays
   int* consensus;                   // Consensus sequence
   int consensus_len;                // Consensus sequence length
+  // Incremental topological order
+  int* reorder_marks;               // Visited marks (per segment id)
+  int reorder_mark;                 // Current mark
+  int* reorder_buffer;              // Temporary buffer (stack/ranks/segments)
+  // Sequences arena
+  mm_allocator_t* mm_sequences;     // Padded sequences of all segments
+  // Packed sequences
+  uint64_t* packed_sequences;       // 2-bit packed sequences of all segments (NULL if not packed)
+  // Frozen (CSR)
+  bool frozen;                      // Read-only snapshot (see text_dag_freeze)
+  text_dag_segment_t* frozen_segments; // Segments (in topological order)
+  char* frozen_sequences;           // Padded sequences (in topological order)
+  int* frozen_edges;                // Next/prev/prev-weight of each segment (in topological order)
+  void* mapped_memory;              // Memory-mapped file (NULL if not loaded from a file)
+  uint64_t mapped_size;             // Memory-mapped file size
 } text_dag_t;
 
 /*
  * Setup
  */
 text_dag_t* text_dag_new();
+text_dag_t* text_dag_new_empty(); // No END segment
 void text_dag_delete(
     text_dag_t* const text_dag);
+void text_dag_reserve(
+    text_dag_t* const text_dag,
+    const int segments_total);
+
+/*
+ * Segments (grow on demand)
+ */
+void text_dag_segment_reserve_prev(
+    text_dag_segment_t* const segment,
+    const int prev_total);
+void text_dag_segment_reserve_next(
+    text_dag_segment_t* const segment,
+    const int next_total);
+void text_dag_segment_reserve_seq_rank(
+    text_dag_segment_t* const segment,
+    const int seq_rank_total);
+void text_dag_segment_add_seq_rank(
+    text_dag_segment_t* const segment,
+    const int seq_rank);
+void text_dag_segment_copy_seq_rank(
+    text_dag_segment_t* const segment_dst,
+    text_dag_segment_t* const segment_src);
 
 /*
  * Accessors
@@ -73,13 +119,110 @@ void text_dag_add_segment(
     text_dag_t* const text_dag,
     char* const sequence,
     const char sentinel);
+void text_dag_add_segment_length(
+    text_dag_t* const text_dag,
+    const char* const sequence,   // Not necessarily NUL-terminated
+    const int sequence_length,
+    const char sentinel);
+void text_dag_add_edge(
+    text_dag_t* const text_dag,
+    const int segment_id_a,
+    const int segment_id_b,
+    const int weight);
 void text_dag_add_connection(
     text_dag_t* const text_dag,
     const int node_a,
     const int node_b,
     const int weight);
+int text_dag_segment_weight(
+    text_dag_t* const text_dag,
+    const int segment_id);
+int text_dag_split_segment(
+    text_dag_t* const text_dag,
+    const int segment_id,
+    const int offset);
 void text_dag_topological_sort(
         text_dag_t* const text_dag);
+
+/*
+ * Incremental topological order
+ *   New segments are ranked last. Connections violating the order only re-rank the
+ *   segments between both ends (reorder, Pearce-Kelly), and segments added in bulk are
+ *   sorted together with the window of ranks they attach to (sort_window); the ranks
+ *   after the window are shifted. Full sorts (topological_sort) only rebuild it from scratch
+ */
+void text_dag_reorder(
+    text_dag_t* const text_dag,
+    const int segment_id_a,
+    const int segment_id_b);
+void text_dag_sort_window(
+    text_dag_t* const text_dag,
+    int rank_begin,
+    int rank_end,
+    const int segment_new_begin);
+
+/*
+ * Progressive POA
+ *   Fuses an aligned sequence into the Text-DAG following its CIGAR (segment operations
+ *   included). Segments are split at the boundaries between matching and differing runs,
+ *   so that matches traverse the existing segments and each differing stretch of the
+ *   pattern is added as a new segment. The Text-DAG is kept with a single source and
+ *   sink (adding empty ones if needed) and topologically sorted (only re-ranking
+ *   the window of ranks spanned by the alignment).
+ */
+int text_dag_add_pattern_segment(
+    text_dag_t* const text_dag,
+    char* const pattern,
+    const int pattern_begin,
+    const int pattern_end);
+void text_dag_add_alignment(
+    text_dag_t* const text_dag,
+    char* const pattern,
+    const int pattern_length,
+    cigar_t* const cigar,
+    const int weight);
+/*
+ * Derived Text-DAGs (require the Text-DAG to be topologically sorted)
+ */
+text_dag_t* text_dag_reverse(
+    text_dag_t* const text_dag);
+text_dag_t* text_dag_subgraph(
+    text_dag_t* const text_dag,
+    const int segment_begin,
+    const int offset_begin,
+    const int segment_end,
+    const int offset_end,
+    int* const segment_ids);
+
+/*
+ * Frozen Text-DAG
+ *   Immutable snapshot for alignment (CSR). Segments, their padded sequences and their
+ *   next/prev/prev-weight arrays are packed contiguously in topological order, so the
+ *   aligners traverse the graph with sequential accesses. Segment ids and ranks are
+ *   kept (CIGARs apply to the original Text-DAG). Packed sequences are packed again,
+ *   while sequence ranks and the consensus are not kept. Can be shared across threads
+ *   without locks (no scratch is written)
+ */
+text_dag_t* text_dag_freeze(
+    text_dag_t* const text_dag);
+
+/*
+ * 2-bit packed sequences (optional)
+ *   Segments made only of A/C/G/T keep a copy of their sequence packed 2 bits per base
+ *   (32 bases per word, first base at the lowest bits), so that extension compares 32
+ *   bases per XOR. Sentinels are not packed (comparisons are bounded by the lengths)
+ *   and one trailing word pads unaligned reads. Segments added afterwards are not
+ *   packed (pack again if needed)
+ */
+#define TEXT_DAG_PACKED_WORDS(length) (DIV_CEIL(length,32)+1)
+
+bool text_dag_sequence_pack(
+    const char* const sequence,
+    const int sequence_length,
+    uint64_t* const sequence_packed);
+void text_dag_pack(
+    text_dag_t* const text_dag);
+
 int text_dag_branch_completion(
         text_dag_t* const text_dag,
         int64_t *scores,
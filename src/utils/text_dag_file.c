@@ -0,0 +1,323 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignments Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignments Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: Binary Text-DAG file (memory-mapped loading)
+ */
+
+#include "text_dag_file.h"
+
+/*
+ * Config
+ */
+#define TEXT_DAG_FILE_ALIGN(num_bytes) ((((uint64_t)(num_bytes))+7) & ~((uint64_t)7))
+
+/*
+ * Write
+ */
+void text_dag_file_write_data(
+    FILE* const file,
+    const void* const data,
+    const uint64_t num_bytes) {
+  if (num_bytes > 0 && fwrite(data,1,num_bytes,file) != num_bytes) {
+    fprintf(stderr,"[wfpoa::text_dag_file_write] error: writing file\n");
+    exit(1);
+  }
+}
+void text_dag_file_write_padding(
+    FILE* const file,
+    const uint64_t section_bytes) {
+  const char padding[8] = {0};
+  text_dag_file_write_data(file,padding,TEXT_DAG_FILE_ALIGN(section_bytes)-section_bytes);
+}
+void text_dag_file_write(
+    text_dag_t* const text_dag,
+    const char* const file_name) {
+  // Parameters
+  const int segments_total = text_dag->segments_total;
+  int rank;
+  // Lay out the segments (in topological order)
+  text_dag_file_segment_t* const segments = calloc(segments_total,sizeof(text_dag_file_segment_t));
+  uint64_t sequences_length = 0, edges_total = 0, seq_ranks_total = 0;
+  for (rank=0;rank<segments_total;++rank) {
+    const int segment_id = text_dag->rank_to_segment_id[rank];
+    text_dag_segment_t* const segment = text_dag->segments_ts[segment_id];
+    segments[rank].sequence_offset = sequences_length;
+    segments[rank].edges_offset = edges_total;
+    segments[rank].seq_rank_offset = seq_ranks_total;
+    segments[rank].segment_id = segment_id;
+    segments[rank].sequence_length = segment->sequence_length;
+    segments[rank].next_total = segment->next_total;
+    segments[rank].prev_total = segment->prev_total;
+    segments[rank].seq_rank_total = segment->seq_rank_total;
+    sequences_length += segment->sequence_length + 3; // Padded and terminated
+    edges_total += segment->next_total + 2*segment->prev_total;
+    seq_ranks_total += segment->seq_rank_total;
+  }
+  const uint64_t ranks_bytes = segments_total*sizeof(int32_t);
+  const uint64_t segments_bytes = segments_total*sizeof(text_dag_file_segment_t);
+  const uint64_t consensus_bytes = text_dag->consensus_len*sizeof(int32_t);
+  const uint64_t edges_bytes = edges_total*sizeof(int32_t);
+  const uint64_t seq_ranks_bytes = seq_ranks_total*sizeof(int32_t);
+  // Header
+  text_dag_file_header_t header;
+  memset(&header,0,sizeof(text_dag_file_header_t));
+  memcpy(header.magic,TEXT_DAG_FILE_MAGIC,8);
+  header.version = TEXT_DAG_FILE_VERSION;
+  header.endianness = TEXT_DAG_FILE_ENDIAN;
+  header.num_sequences = text_dag->num_sequences;
+  header.segments_total = segments_total;
+  header.consensus_len = text_dag->consensus_len;
+  header.rank_to_segment_id_offset = TEXT_DAG_FILE_ALIGN(sizeof(text_dag_file_header_t));
+  header.segment_id_to_rank_offset = header.rank_to_segment_id_offset + TEXT_DAG_FILE_ALIGN(ranks_bytes);
+  header.segments_offset = header.segment_id_to_rank_offset + TEXT_DAG_FILE_ALIGN(ranks_bytes);
+  header.consensus_offset = header.segments_offset + TEXT_DAG_FILE_ALIGN(segments_bytes);
+  header.edges_offset = header.consensus_offset + TEXT_DAG_FILE_ALIGN(consensus_bytes);
+  header.seq_ranks_offset = header.edges_offset + TEXT_DAG_FILE_ALIGN(edges_bytes);
+  header.sequences_offset = header.seq_ranks_offset + TEXT_DAG_FILE_ALIGN(seq_ranks_bytes);
+  header.file_size = header.sequences_offset + TEXT_DAG_FILE_ALIGN(sequences_length);
+  // Open file
+  FILE* const file = fopen(file_name,"wb");
+  if (file == NULL) {
+    fprintf(stderr,"[wfpoa::text_dag_file_write] error: cannot open '%s'\n",file_name);
+    exit(1);
+  }
+  // Write header, ranks, segments and consensus
+  text_dag_file_write_data(file,&header,sizeof(text_dag_file_header_t));
+  text_dag_file_write_padding(file,sizeof(text_dag_file_header_t));
+  text_dag_file_write_data(file,text_dag->rank_to_segment_id,ranks_bytes);
+  text_dag_file_write_padding(file,ranks_bytes);
+  text_dag_file_write_data(file,text_dag->segment_id_to_rank,ranks_bytes);
+  text_dag_file_write_padding(file,ranks_bytes);
+  text_dag_file_write_data(file,segments,segments_bytes);
+  text_dag_file_write_padding(file,segments_bytes);
+  text_dag_file_write_data(file,text_dag->consensus,consensus_bytes);
+  text_dag_file_write_padding(file,consensus_bytes);
+  // Write edges
+  for (rank=0;rank<segments_total;++rank) {
+    text_dag_segment_t* const segment = text_dag->segments_ts[segments[rank].segment_id];
+    text_dag_file_write_data(file,segment->next,segment->next_total*sizeof(int32_t));
+    text_dag_file_write_data(file,segment->prev,segment->prev_total*sizeof(int32_t));
+    text_dag_file_write_data(file,segment->prev_weight,segment->prev_total*sizeof(int32_t));
+  }
+  text_dag_file_write_padding(file,edges_bytes);
+  // Write sequence ranks
+  for (rank=0;rank<segments_total;++rank) {
+    text_dag_segment_t* const segment = text_dag->segments_ts[segments[rank].segment_id];
+    text_dag_file_write_data(file,segment->seq_rank,segment->seq_rank_total*sizeof(int32_t));
+  }
+  text_dag_file_write_padding(file,seq_ranks_bytes);
+  // Write padded sequences
+  for (rank=0;rank<segments_total;++rank) {
+    text_dag_segment_t* const segment = text_dag->segments_ts[segments[rank].segment_id];
+    text_dag_file_write_data(file,segment->sequence-1,segment->sequence_length+3);
+  }
+  text_dag_file_write_padding(file,sequences_length);
+  // Close
+  if (fclose(file) != 0) {
+    fprintf(stderr,"[wfpoa::text_dag_file_write] error: writing file\n");
+    exit(1);
+  }
+  free(segments);
+}
+/*
+ * Check (before trusting any count or offset of the file)
+ */
+bool text_dag_file_check_range(
+    const int64_t offset,
+    const int64_t length,
+    const uint64_t section_bytes) {
+  // Check [offset,offset+length) lies within the section
+  if (offset < 0 || length < 0) return false;
+  if ((uint64_t)offset > section_bytes) return false;
+  return (uint64_t)length <= section_bytes - (uint64_t)offset;
+}
+bool text_dag_file_check_ids(
+    const int32_t* const ids,
+    const int64_t num_ids,
+    const int32_t ids_max) {
+  // Check ids lie within [0,ids_max)
+  int64_t i;
+  for (i=0;i<num_ids;++i) {
+    if (ids[i] < 0 || ids[i] >= ids_max) return false;
+  }
+  return true;
+}
+bool text_dag_file_check(
+    const char* const mapped_memory,
+    const uint64_t mapped_size) {
+  // Check format
+  const text_dag_file_header_t* const header = (const text_dag_file_header_t*)mapped_memory;
+  if (memcmp(header->magic,TEXT_DAG_FILE_MAGIC,8) != 0 ||
+      header->version != TEXT_DAG_FILE_VERSION ||
+      header->endianness != TEXT_DAG_FILE_ENDIAN ||
+      header->file_size != mapped_size) return false;
+  // Check counts
+  const int32_t segments_total = header->segments_total;
+  if (segments_total < 0 || header->consensus_len < 0 || header->num_sequences < 0) return false;
+  // Check sections (8-byte aligned, within the file and in layout order)
+  const uint64_t section_offsets[] = {
+      TEXT_DAG_FILE_ALIGN(sizeof(text_dag_file_header_t)),
+      header->rank_to_segment_id_offset, header->segment_id_to_rank_offset,
+      header->segments_offset, header->consensus_offset, header->edges_offset,
+      header->seq_ranks_offset, header->sequences_offset, header->file_size };
+  const uint64_t section_min_bytes[] = {
+      0, segments_total*sizeof(int32_t), segments_total*sizeof(int32_t),
+      segments_total*sizeof(text_dag_file_segment_t), header->consensus_len*sizeof(int32_t),
+      0, 0, 0 };
+  int i;
+  for (i=1;i<9;++i) {
+    if (section_offsets[i]%8 != 0) return false;
+    if (section_offsets[i] < section_offsets[i-1]) return false;
+    if (section_offsets[i] - section_offsets[i-1] < section_min_bytes[i-1]) return false;
+  }
+  const uint64_t edges_bytes = header->seq_ranks_offset - header->edges_offset;
+  const uint64_t seq_ranks_bytes = header->sequences_offset - header->seq_ranks_offset;
+  const uint64_t sequences_bytes = header->file_size - header->sequences_offset;
+  // Check topological order (permutation of the segment ids)
+  const int32_t* const rank_to_segment_id =
+      (const int32_t*)(mapped_memory + header->rank_to_segment_id_offset);
+  const int32_t* const segment_id_to_rank =
+      (const int32_t*)(mapped_memory + header->segment_id_to_rank_offset);
+  if (!text_dag_file_check_ids(rank_to_segment_id,segments_total,segments_total)) return false;
+  int32_t rank;
+  for (rank=0;rank<segments_total;++rank) {
+    if (segment_id_to_rank[rank_to_segment_id[rank]] != rank) return false;
+  }
+  // Check consensus
+  const int32_t* const consensus = (const int32_t*)(mapped_memory + header->consensus_offset);
+  if (!text_dag_file_check_ids(consensus,header->consensus_len,segments_total)) return false;
+  // Check segment records
+  const text_dag_file_segment_t* const segments =
+      (const text_dag_file_segment_t*)(mapped_memory + header->segments_offset);
+  const char* const sequences = mapped_memory + header->sequences_offset;
+  const int32_t* const edges = (const int32_t*)(mapped_memory + header->edges_offset);
+  for (rank=0;rank<segments_total;++rank) {
+    const text_dag_file_segment_t* const segment_file = segments + rank;
+    if (segment_file->segment_id != rank_to_segment_id[rank]) return false;
+    if (segment_file->sequence_length < 0 || segment_file->next_total < 0 ||
+        segment_file->prev_total < 0 || segment_file->seq_rank_total < 0) return false;
+    // Padded sequence
+    const int64_t sequence_length = segment_file->sequence_length;
+    if (!text_dag_file_check_range(segment_file->sequence_offset,
+        sequence_length+3,sequences_bytes)) return false;
+    const char* const sequence = sequences + segment_file->sequence_offset + 1;
+    if (sequence[sequence_length] != sequence[-1] || sequence[sequence_length+1] != '\0') return false;
+    // Edges
+    const int64_t num_edges = (int64_t)segment_file->next_total + 2*(int64_t)segment_file->prev_total;
+    if (!text_dag_file_check_range(segment_file->edges_offset,num_edges,
+        edges_bytes/sizeof(int32_t))) return false;
+    const int32_t* const next = edges + segment_file->edges_offset;
+    const int64_t num_links = (int64_t)segment_file->next_total + segment_file->prev_total;
+    if (!text_dag_file_check_ids(next,num_links,segments_total)) return false;
+    // Sequence ranks
+    if (!text_dag_file_check_range(segment_file->seq_rank_offset,
+        segment_file->seq_rank_total,seq_ranks_bytes/sizeof(int32_t))) return false;
+  }
+  // Valid
+  return true;
+}
+/*
+ * Load (memory-mapped)
+ */
+text_dag_t* text_dag_file_load(
+    const char* const file_name) {
+  // Map file
+  const int fd = open(file_name,O_RDONLY);
+  if (fd == -1) {
+    fprintf(stderr,"[wfpoa::text_dag_file_load] error: cannot open '%s'\n",file_name);
+    exit(1);
+  }
+  struct stat file_stat;
+  if (fstat(fd,&file_stat) == -1 || file_stat.st_size < (off_t)sizeof(text_dag_file_header_t)) {
+    fprintf(stderr,"[wfpoa::text_dag_file_load] error: invalid file '%s'\n",file_name);
+    exit(1);
+  }
+  const uint64_t mapped_size = file_stat.st_size;
+  char* const mapped_memory = mmap(NULL,mapped_size,PROT_READ,MAP_SHARED,fd,0);
+  close(fd);
+  if (mapped_memory == MAP_FAILED) {
+    fprintf(stderr,"[wfpoa::text_dag_file_load] error: cannot map '%s'\n",file_name);
+    exit(1);
+  }
+  // Check header and sections
+  if (!text_dag_file_check(mapped_memory,mapped_size)) {
+    munmap(mapped_memory,mapped_size);
+    fprintf(stderr,"[wfpoa::text_dag_file_load] error: invalid file '%s'\n",file_name);
+    exit(1);
+  }
+  const text_dag_file_header_t* const header = (const text_dag_file_header_t*)mapped_memory;
+  // Allocate (frozen Text-DAG over the mapped sections)
+  const int segments_total = header->segments_total;
+  text_dag_t* const text_dag = malloc(sizeof(text_dag_t));
+  text_dag->num_sequences = header->num_sequences;
+  text_dag->segments_ts = malloc(segments_total*sizeof(text_dag_segment_t*));
+  text_dag->rank_to_segment_id = (int*)(mapped_memory + header->rank_to_segment_id_offset);
+  text_dag->segment_id_to_rank = (int*)(mapped_memory + header->segment_id_to_rank_offset);
+  text_dag->segments_total = segments_total;
+  text_dag->segments_allocated = segments_total;
+  text_dag->consensus = (int*)(mapped_memory + header->consensus_offset);
+  text_dag->consensus_len = header->consensus_len;
+  text_dag->reorder_marks = NULL;
+  text_dag->reorder_mark = 0;
+  text_dag->reorder_buffer = NULL;
+  text_dag->mm_sequences = NULL;
+  text_dag->packed_sequences = NULL;
+  text_dag->frozen = true;
+  text_dag->frozen_segments = malloc(segments_total*sizeof(text_dag_segment_t));
+  text_dag->frozen_sequences = NULL; // Mapped
+  text_dag->frozen_edges = NULL;     // Mapped
+  text_dag->mapped_memory = mapped_memory;
+  text_dag->mapped_size = mapped_size;
+  // Set the segment views (in topological order)
+  const text_dag_file_segment_t* const segments =
+      (const text_dag_file_segment_t*)(mapped_memory + header->segments_offset);
+  char* const sequences = mapped_memory + header->sequences_offset;
+  int* const edges = (int*)(mapped_memory + header->edges_offset);
+  int* const seq_ranks = (int*)(mapped_memory + header->seq_ranks_offset);
+  int rank;
+  for (rank=0;rank<segments_total;++rank) {
+    const text_dag_file_segment_t* const segment_file = segments + rank;
+    text_dag_segment_t* const segment = text_dag->frozen_segments + rank;
+    segment->sequence = sequences + segment_file->sequence_offset + 1;
+    segment->sequence_length = segment_file->sequence_length;
+    segment->sequence_packed = NULL;
+    segment->next = edges + segment_file->edges_offset;
+    segment->next_total = segment_file->next_total;
+    segment->next_allocated = segment_file->next_total;
+    segment->prev = segment->next + segment_file->next_total;
+    segment->prev_total = segment_file->prev_total;
+    segment->prev_allocated = segment_file->prev_total;
+    segment->prev_weight = segment->prev + segment_file->prev_total;
+    segment->seq_rank = seq_ranks + segment_file->seq_rank_offset;
+    segment->seq_rank_total = segment_file->seq_rank_total;
+    segment->seq_rank_allocated = segment_file->seq_rank_total;
+    text_dag->segments_ts[segment_file->segment_id] = segment;
+  }
+  // Return
+  return text_dag;
+}
@@ -0,0 +1,98 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignments Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignments Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: Binary Text-DAG file (memory-mapped loading)
+ */
+
+#ifndef TEXT_DAG_FILE_H_
+#define TEXT_DAG_FILE_H_
+
+#include "commons.h"
+#include "text_dag.h"
+
+/*
+ * Text-DAG File
+ *   Binary image of a Text-DAG (native endianness). Sections are 8-byte aligned and laid
+ *   out in topological order, like the frozen Text-DAG (see text_dag_freeze): ranks,
+ *   segment records, consensus, edges (next/prev/prev-weight of each segment), sequence
+ *   ranks and padded sequences
+ */
+#define TEXT_DAG_FILE_MAGIC   "WFPOADAG"
+#define TEXT_DAG_FILE_VERSION 1
+#define TEXT_DAG_FILE_ENDIAN  0x01020304
+
+typedef struct {
+  // Format
+  char magic[8];                    // TEXT_DAG_FILE_MAGIC
+  uint32_t version;                 // TEXT_DAG_FILE_VERSION
+  uint32_t endianness;              // TEXT_DAG_FILE_ENDIAN (as written)
+  // Text-DAG
+  int32_t num_sequences;
+  int32_t segments_total;
+  int32_t consensus_len;
+  int32_t padding;
+  // Sections (offsets in bytes from the beginning of the file)
+  uint64_t rank_to_segment_id_offset; // int32_t[segments_total]
+  uint64_t segment_id_to_rank_offset; // int32_t[segments_total]
+  uint64_t segments_offset;         // text_dag_file_segment_t[segments_total] (in topological order)
+  uint64_t consensus_offset;        // int32_t[consensus_len]
+  uint64_t edges_offset;            // int32_t[]
+  uint64_t seq_ranks_offset;        // int32_t[]
+  uint64_t sequences_offset;        // char[]
+  uint64_t file_size;
+} text_dag_file_header_t;
+typedef struct {
+  int64_t sequence_offset;          // Padded sequence (within the sequences section)
+  int64_t edges_offset;             // Next, prev and prev-weight (within the edges section)
+  int64_t seq_rank_offset;          // Sequence ranks (within the sequence-ranks section)
+  int32_t segment_id;
+  int32_t sequence_length;
+  int32_t next_total;
+  int32_t prev_total;
+  int32_t seq_rank_total;
+  int32_t padding;
+} text_dag_file_segment_t;
+
+/*
+ * Write
+ */
+void text_dag_file_write(
+    text_dag_t* const text_dag,
+    const char* const file_name);
+
+/*
+ * Load (memory-mapped)
+ *   Maps the file read-only and returns a frozen Text-DAG whose sequences, edges, ranks
+ *   and consensus are used in place (only the segment views are allocated). The mapping
+ *   is shared through the page cache and released with text_dag_delete. Counts, offsets
+ *   and segment ids are checked against the sections before use (invalid files exit)
+ */
+text_dag_t* text_dag_file_load(
+    const char* const file_name);
+
+#endif /* TEXT_DAG_FILE_H_ */